@@ -4,15 +4,22 @@
 
 #include "json-common.h"
 #include "json-serializer.h"
+#include "json-cbor.h"
+#include "json-msgpack.h"
 
 namespace json {
 	namespace detail {
 		struct BuildAnyType {};
+
+		/* element-types of ranges, which can be pushed at once (ranges of characters are
+		*	strings and must be pushed as such, instead of as a range of integers) */
+		template <class Type>
+		concept IsRangeElement = (json::IsPrimitive<Type> && !str::IsChar<std::remove_cvref_t<Type>>) || json::IsString<Type>;
 	}
 
 	/* check if the given type is a valid builder-sink */
 	template <class Type>
-	concept IsBuildType = str::IsSink<Type> || std::is_same_v<Type, detail::BuildAnyType>;
+	concept IsBuildType = json::IsOutput<Type> || std::is_same_v<Type, detail::BuildAnyType>;
 
 	template <json::IsBuildType SinkType, char32_t CodeError = str::err::DefChar>
 	class Builder;
@@ -31,24 +38,42 @@ namespace json {
 			};
 
 		private:
-			using ActSink = std::conditional_t<std::is_same_v<SinkType, detail::BuildAnyType>, std::unique_ptr<str::InheritSink>, SinkType&>;
+			/* any-builders serialize into a local block of codepoints, which is passed to the type-erased sink once full */
+			static constexpr bool IsAny = std::is_same_v<SinkType, detail::BuildAnyType>;
+			using ActSink = std::conditional_t<IsAny, std::u32string, SinkType&>;
+
+			/* number of values of a range to be written out at once by any-builders, before checking if the block is full */
+			static constexpr size_t RangeChunk = 256;
 
 		private:
 			detail::Serializer<ActSink, CodeError> pSerializer;
+			std::unique_ptr<detail::BlockSink> pBlockSink;
 			std::vector<Instance*> pActive;
 			size_t pNextStamp = 0;
 			bool pAwaitingValue = false;
 
 		public:
-			constexpr BuilderState(ActSink&& sink, const std::wstring_view& indent) : pSerializer{ std::forward<ActSink>(sink), indent } {}
+			constexpr BuilderState(SinkType& sink, const std::wstring_view& indent) requires (!IsAny) : pSerializer{ sink, indent } {}
+			constexpr BuilderState(std::unique_ptr<detail::BlockSink>&& sink, const std::wstring_view& indent) requires IsAny : pSerializer{ std::u32string{}, indent }, pBlockSink{ std::move(sink) } {}
 			constexpr ~BuilderState() {
 				/* check if a single value remains (can happen if nothing is ever written out) */
 				if (pAwaitingValue)
 					pSerializer.primitive(json::Null());
 				pAwaitingValue = false;
+				fFlush(true);
 			}
 
 		private:
+			constexpr void fFlush(bool all) {
+				if constexpr (IsAny) {
+					/* check if the block is full or if all remaining codepoints should be written out */
+					std::u32string& block = pSerializer.sink();
+					if (block.empty() || (!all && block.size() < detail::BlockSize))
+						return;
+					pBlockSink->write(block);
+					block.clear();
+				}
+			}
 			constexpr void fCloseTop() {
 				Instance* instance = pActive.back();
 
@@ -140,6 +165,7 @@ namespace json {
 					return;
 				fEnsureTopMost(instance);
 				fCloseTop();
+				fFlush(pActive.empty());
 			}
 			constexpr size_t allocFirst() {
 				pAwaitingValue = true;
@@ -157,6 +183,7 @@ namespace json {
 				else
 					pSerializer.arrayValue();
 				pAwaitingValue = true;
+				fFlush(false);
 				return ++pNextStamp;
 			}
 			constexpr std::unique_ptr<Instance> open(size_t stamp, bool object) {
@@ -169,11 +196,30 @@ namespace json {
 				/* write the starting out and push the new instance as active object */
 				pSerializer.begin(object);
 				pActive.push_back(instance.get());
+				fFlush(false);
 				return std::move(instance);
 			}
 			constexpr void next(size_t stamp, const auto& value) {
 				fCheckStamp(stamp);
 				fWrite(value);
+				fFlush(pActive.empty());
+			}
+			constexpr void nextRange(Instance* instance, const auto& values) {
+				/* check if this array is already closed and can therefore not capture the focus anymore and otherwise focus it */
+				if (instance->closed)
+					throw json::BuilderException(L"Builder is not in an active state");
+				fEnsureTopMost(instance);
+
+				/* write all values out without any intermediate value-states (any-builders write the values in chunks,
+				*	in order to pass full blocks to the sink instead of buffering the entire range) */
+				if constexpr (IsAny) {
+					for (size_t i = 0; i < values.size(); i += RangeChunk) {
+						pSerializer.arrayValues(values.subspan(i, std::min(RangeChunk, values.size() - i)));
+						fFlush(false);
+					}
+				}
+				else
+					pSerializer.arrayValues(values);
 			}
 		};
 
@@ -373,13 +419,28 @@ namespace json {
 			size_t stamp = pBuilder->allocNext(pInstance.get(), L"");
 			pBuilder->next(stamp, v);
 		}
+
+		/* push all primitives or strings of the range (equivalent to pushing each value individually, but
+		*	writes the values out in a single pass without setting up an intermediate value-builder per value)
+		*	Note: ranges of characters are not accepted, as they are strings, which are pushed by push */
+		template <detail::IsRangeElement Type>
+		void pushRange(std::span<const Type> values) {
+			pBuilder->nextRange(pInstance.get(), values);
+		}
+
+		/* push all primitives or strings of the contiguous range (equivalent to pushRange of the corresponding span) */
+		template <std::ranges::contiguous_range RangeType>
+			requires detail::IsRangeElement<std::ranges::range_value_t<RangeType>>
+		void pushRange(const RangeType& values) {
+			pBuilder->nextRange(pInstance.get(), std::span<const std::ranges::range_value_t<RangeType>>{ values });
+		}
 	};
 
 	/* construct a json builder-value to the given sink, using the corresponding indentation, which writes all
 	*	values out immediately, preventing an intermediate state from being created (indentation will be sanitized
 	*	to only contain spaces and tabs, if indentation is empty, a compact json stream will be produced)
 	*	Note: Must not outlive the sink as it stores a reference to it */
-	template <str::IsSink SinkType, char32_t CodeError = str::err::DefChar>
+	template <json::IsOutput SinkType, char32_t CodeError = str::err::DefChar>
 	constexpr json::Builder<std::remove_cvref_t<SinkType>, CodeError> Build(SinkType&& sink, const std::wstring_view& indent = L"\t") {
 		using ActSink = std::remove_cvref_t<SinkType>;
 
@@ -388,7 +449,8 @@ namespace json {
 		return detail::BuildAccess::MakeValue<ActSink, CodeError>(state, state->allocFirst());
 	}
 
-	/* same as json::Builder, but uses inheritance to hide the underlying sink-type
+	/* same as json::Builder, but uses inheritance to hide the underlying sink-type (values are collected
+	*	into blocks, which are written out once full or once the root value has been completed)
 	*	Note: This is a light-weight object, which can just be copied around, as it keeps a reference to the actual state */
 	using AnyBuilder = json::Builder<detail::BuildAnyType, str::err::DefChar>;
 
@@ -405,10 +467,8 @@ namespace json {
 	*	Note: Must not outlive the sink as it stores a reference to it */
 	template <str::IsSink SinkType>
 	constexpr json::AnyBuilder BuildAny(SinkType&& sink, const std::wstring_view& indent = L"\t") {
-		using ActSink = std::remove_cvref_t<SinkType>;
-
 		/* wrap the sink to be held by the builder */
-		std::unique_ptr<str::InheritSink> buildSink = std::make_unique<str::SinkImplementation<ActSink>>(std::forward<SinkType>(sink));
+		std::unique_ptr<detail::BlockSink> buildSink = std::make_unique<detail::BlockSinkImpl<SinkType, str::err::DefChar>>(std::forward<SinkType>(sink));
 
 		/* setup the shared state and setup the root value */
 		auto state = std::make_shared<detail::BuilderState<detail::BuildAnyType, str::err::DefChar>>(std::move(buildSink), indent);
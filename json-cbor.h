@@ -0,0 +1,494 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include "json-common.h"
+#include "json-deserializer.h"
+#include "json-serializer.h"
+
+namespace json {
+	/* cbor-encoded (RFC 8949) bytes, which can be passed to json::Read/json::View/json::Deserialize/json::Project in place of a
+	*	character-stream, and which are decoded to the same json-values (the bytes are referenced and must outlive the reading)
+	*	- byte-strings are converted to base64url-encoded strings, and tags are ignored, as recommended by RFC 8949 [6.1]
+	*	- undefined and all unassigned simple values are interpreted as null
+	*	- only strings are supported as object-keys */
+	class CborSource {
+	private:
+		std::span<const uint8_t> pBytes;
+
+	public:
+		constexpr CborSource() = default;
+		constexpr CborSource(std::span<const uint8_t> bytes) : pBytes{ bytes } {}
+		CborSource(std::string_view bytes) : pBytes{ reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size() } {}
+
+	public:
+		constexpr std::span<const uint8_t> bytes() const {
+			return pBytes;
+		}
+	};
+
+	/* reference to a byte-sink, which can be passed to json::Build/json::SerializeTo in place of a character-sink, to write
+	*	the values cbor-encoded (RFC 8949) to the sink (arrays and objects are written with indefinite lengths, as their sizes
+	*	are not known upfront by the builders, reals are written as single-precision floats, if they can be represented exactly)
+	*	Note: Must not outlive the sink as it stores a reference to it */
+	template <json::IsByteSink SinkType>
+	class CborSink {
+	private:
+		SinkType* pSink = nullptr;
+
+	public:
+		constexpr CborSink(SinkType& sink) : pSink{ &sink } {}
+
+	public:
+		constexpr void write(const uint8_t* data, size_t size) {
+			detail::WriteBytes(*pSink, data, size);
+		}
+	};
+
+	namespace detail {
+		template <class Type>
+		struct CborSinkCheck : std::false_type {};
+		template <class SinkType>
+		struct CborSinkCheck<json::CborSink<SinkType>> : std::true_type {};
+
+		template <>
+		struct BinaryInput<json::CborSource> : std::true_type {};
+		template <class SinkType>
+		struct BinaryOutput<json::CborSink<SinkType>> : std::true_type {};
+	}
+
+	/* check if the type is cbor-encoded input or output */
+	template <class Type>
+	concept IsCborSource = std::is_same_v<std::remove_cvref_t<Type>, json::CborSource>;
+	template <class Type>
+	concept IsCborSink = detail::CborSinkCheck<std::remove_cvref_t<Type>>::value;
+
+	namespace detail {
+		/* major types of the initial bytes of cbor data-items */
+		enum class CborMajor : uint8_t {
+			unum,
+			nnum,
+			bytes,
+			text,
+			array,
+			map,
+			tag,
+			simple
+		};
+		static constexpr uint8_t CborIndefinite = 31;
+		static constexpr uint8_t CborBreak = 0xff;
+
+		/* simple values and float-sizes of the additional information of the major type [simple] */
+		static constexpr uint8_t CborFalse = 20;
+		static constexpr uint8_t CborTrue = 21;
+		static constexpr uint8_t CborNull = 22;
+		static constexpr uint8_t CborHalf = 25;
+		static constexpr uint8_t CborSingle = 26;
+		static constexpr uint8_t CborDouble = 27;
+
+		template <class StreamType, char32_t CodeError>
+			requires json::IsCborSource<StreamType>
+		class Deserializer<StreamType, CodeError> {
+		private:
+			struct Head {
+				detail::CborMajor major = detail::CborMajor::unum;
+				uint8_t info = 0;
+				uint64_t arg = 0;
+			};
+			/* remaining data-items of definite containers (keys and values of maps are counted separately,
+			*	which allows the containers to be skipped at any point without relying on the separators) */
+			struct Level {
+				uint64_t remaining = 0;
+				bool indefinite = false;
+			};
+
+		private:
+			std::span<const uint8_t> pBytes;
+			std::vector<Level> pLevels;
+			std::vector<Level> pSkip;
+			std::vector<uint8_t> pBuffer;
+			size_t pOffset = 0;
+			size_t pTokenOffset = 0;
+			size_t pOrigin = 0;
+
+		public:
+			constexpr Deserializer(const json::CborSource& s) : pBytes{ s.bytes() } {}
+
+		private:
+			constexpr void fParseError(const char8_t* what) {
+				throw json::DeserializeException(what, L" while parsing the cbor at byte ", pOrigin + pTokenOffset);
+			}
+			constexpr void fEnsure(size_t count) {
+				if (pBytes.size() - pOffset < count)
+					throw json::DeserializeException(L"Unexpected <EOF> encountered at byte ", pOrigin + pBytes.size());
+			}
+			constexpr uint8_t fPeekByte() {
+				fEnsure(1);
+				return pBytes[pOffset];
+			}
+			constexpr Head fReadHead() {
+				/* decode the initial byte and the big-endian argument following it */
+				fEnsure(1);
+				pTokenOffset = pOffset;
+				Head head{ detail::CborMajor(pBytes[pOffset] >> 5), uint8_t(pBytes[pOffset] & 0x1f), 0 };
+				++pOffset;
+				if (head.info < 24)
+					head.arg = head.info;
+				else if (head.info <= 27) {
+					size_t size = size_t(1) << (head.info - 24);
+					fEnsure(size);
+					for (size_t i = 0; i < size; ++i)
+						head.arg = (head.arg << 8) | pBytes[pOffset++];
+				}
+				else if (head.info != detail::CborIndefinite || head.major == detail::CborMajor::unum || head.major == detail::CborMajor::nnum || head.major == detail::CborMajor::tag)
+					fParseError(u8"Malformed additional information encountered");
+				return head;
+			}
+			constexpr Head fPeekHead() {
+				/* skip all tags and peek the head of the tagged data-item */
+				while (true) {
+					size_t offset = pOffset;
+					Head head = fReadHead();
+					if (head.major == detail::CborMajor::tag)
+						continue;
+					pOffset = offset;
+					return head;
+				}
+			}
+			constexpr std::span<const uint8_t> fPayload(uint64_t size) {
+				if (size > pBytes.size() - pOffset)
+					fEnsure(pBytes.size() - pOffset + 1);
+				std::span<const uint8_t> out = pBytes.subspan(pOffset, size_t(size));
+				pOffset += size_t(size);
+				return out;
+			}
+			constexpr void fText(std::span<const uint8_t> bytes, auto& put) {
+				std::u8string_view view{ reinterpret_cast<const char8_t*>(bytes.data()), bytes.size() };
+				while (!view.empty()) {
+					auto [cp, len] = str::GetCodepoint<CodeError>(view);
+					if (len == 0)
+						fParseError(u8"Incomplete utf-8 encoded codepoint in text-string encountered");
+					view = view.substr(len);
+					if (cp != str::Invalid)
+						put(cp);
+				}
+			}
+			constexpr void fReadString(auto&& put, bool key) {
+				Head head = fPeekHead();
+				if (head.major != detail::CborMajor::text && head.major != detail::CborMajor::bytes) {
+					fReadHead();
+					fParseError(key ? u8"Object-key which is not a string encountered" : u8"Unexpected data-item encountered when string was expected");
+				}
+				head = fReadHead();
+				bool text = (head.major == detail::CborMajor::text);
+				pBuffer.clear();
+
+				/* collect the chunks of indefinite strings, which must be definite strings of the same major type */
+				if (head.info != detail::CborIndefinite) {
+					if (text)
+						fText(fPayload(head.arg), put);
+					else {
+						std::span<const uint8_t> bytes = fPayload(head.arg);
+						pBuffer.assign(bytes.begin(), bytes.end());
+					}
+				}
+				else while (fPeekByte() != detail::CborBreak) {
+					Head chunk = fReadHead();
+					if (chunk.major != head.major || chunk.info == detail::CborIndefinite)
+						fParseError(u8"Malformed chunk of indefinite string encountered");
+					std::span<const uint8_t> bytes = fPayload(chunk.arg);
+					if (text)
+						fText(bytes, put);
+					else
+						pBuffer.insert(pBuffer.end(), bytes.begin(), bytes.end());
+				}
+				if (head.info == detail::CborIndefinite)
+					++pOffset;
+				if (!text)
+					detail::Base64Url(pBuffer, put);
+				fConsumed();
+			}
+			static constexpr json::Real fHalf(uint16_t half) {
+				/* decode the half-precision float (RFC 8949 [Appendix D]) */
+				int exponent = (half >> 10) & 0x1f;
+				json::Real mantissa = json::Real(half & 0x03ff);
+				json::Real value = 0;
+				if (exponent == 0)
+					value = std::ldexp(mantissa, -24);
+				else if (exponent != 31)
+					value = std::ldexp(mantissa + 1024, exponent - 25);
+				else
+					value = (mantissa == 0 ? std::numeric_limits<json::Real>::infinity() : std::numeric_limits<json::Real>::quiet_NaN());
+				return ((half & 0x8000) ? -value : value);
+			}
+			constexpr void fPush(const Head& head, bool object) {
+				if (object && head.info != detail::CborIndefinite && head.arg > std::numeric_limits<uint64_t>::max() / 2)
+					fParseError(u8"Map with too many entries encountered");
+				pLevels.push_back(Level{ object ? 2 * head.arg : head.arg, head.info == detail::CborIndefinite });
+			}
+			constexpr void fConsumed() {
+				if (!pLevels.empty() && !pLevels.back().indefinite)
+					--pLevels.back().remaining;
+			}
+			constexpr bool fClose() {
+				/* check if the opened container has been completed and pop it (counts as consumed data-item of the parent) */
+				Level& level = pLevels.back();
+				if (level.indefinite ? (fPeekByte() != detail::CborBreak) : (level.remaining != 0))
+					return false;
+				if (level.indefinite)
+					++pOffset;
+				pLevels.pop_back();
+				fConsumed();
+				return true;
+			}
+			constexpr void fSkipItems(uint64_t count, bool indefinite) {
+				/* skip the data-items without decoding any strings or numbers (jumps over definite strings) */
+				pSkip.assign(1, Level{ count, indefinite });
+				while (!pSkip.empty()) {
+					if (pSkip.back().indefinite) {
+						if (fPeekByte() == detail::CborBreak) {
+							++pOffset;
+							pSkip.pop_back();
+							continue;
+						}
+					}
+					else if (pSkip.back().remaining-- == 0) {
+						pSkip.pop_back();
+						continue;
+					}
+
+					Head head = fReadHead();
+					switch (head.major) {
+					case detail::CborMajor::bytes:
+					case detail::CborMajor::text:
+						if (head.info == detail::CborIndefinite)
+							pSkip.push_back(Level{ 0, true });
+						else
+							fPayload(head.arg);
+						break;
+					case detail::CborMajor::array:
+						pSkip.push_back(Level{ head.arg, head.info == detail::CborIndefinite });
+						break;
+					case detail::CborMajor::map:
+						if (head.info != detail::CborIndefinite && head.arg > std::numeric_limits<uint64_t>::max() / 2)
+							fParseError(u8"Map with too many entries encountered");
+						pSkip.push_back(Level{ 2 * head.arg, head.info == detail::CborIndefinite });
+						break;
+					case detail::CborMajor::tag:
+						pSkip.push_back(Level{ 1, false });
+						break;
+					case detail::CborMajor::simple:
+						if (head.info == detail::CborIndefinite)
+							fParseError(u8"Unexpected break encountered");
+						break;
+					default:
+						break;
+					}
+				}
+			}
+
+		public:
+			constexpr bool closeElseSeparator(bool) {
+				/* cbor does not have separators, and the container is closed once all entries have been read or its break has been reached */
+				return fClose();
+			}
+			constexpr bool checkIsEmpty(bool) {
+				return fClose();
+			}
+			constexpr json::Type peekOrOpenNext() {
+				Head head = fPeekHead();
+				switch (head.major) {
+				case detail::CborMajor::array:
+				case detail::CborMajor::map:
+					fPush(fReadHead(), head.major == detail::CborMajor::map);
+					return (head.major == detail::CborMajor::map ? json::Type::object : json::Type::array);
+				case detail::CborMajor::bytes:
+				case detail::CborMajor::text:
+					return json::Type::string;
+				case detail::CborMajor::unum:
+				case detail::CborMajor::nnum:
+					return json::Type::inumber;
+				default:
+					break;
+				}
+
+				/* check the simple values and floats */
+				if (head.info == detail::CborFalse || head.info == detail::CborTrue)
+					return json::Type::boolean;
+				if (head.info == detail::CborHalf || head.info == detail::CborSingle || head.info == detail::CborDouble)
+					return json::Type::real;
+				if (head.info == detail::CborIndefinite) {
+					fReadHead();
+					fParseError(u8"Unexpected break encountered");
+				}
+				return json::Type::null;
+			}
+			constexpr json::Null readNull() {
+				fPeekHead();
+				fReadHead();
+				fConsumed();
+				return json::Null();
+			}
+			constexpr json::Bool readBoolean() {
+				fPeekHead();
+				json::Bool value = (fReadHead().info == detail::CborTrue);
+				fConsumed();
+				return value;
+			}
+			constexpr detail::NumberValue readNumber() {
+				fPeekHead();
+				Head head = fReadHead();
+				fConsumed();
+				if (head.major == detail::CborMajor::unum)
+					return json::UNum(head.arg);
+
+				/* negative numbers out of the signed range are interpreted as reals (equivalent to json-numbers) */
+				if (head.major == detail::CborMajor::nnum) {
+					if (head.arg <= uint64_t(std::numeric_limits<json::INum>::max()))
+						return json::INum(-1 - json::INum(head.arg));
+					return json::Real(-1.0 - json::Real(head.arg));
+				}
+				if (head.info == detail::CborHalf)
+					return fHalf(uint16_t(head.arg));
+				if (head.info == detail::CborSingle) {
+					uint32_t bits = uint32_t(head.arg);
+					float value = 0;
+					std::memcpy(&value, &bits, sizeof(value));
+					return json::Real(value);
+				}
+				double value = 0;
+				std::memcpy(&value, &head.arg, sizeof(value));
+				return json::Real(value);
+			}
+			constexpr void readString(auto& sink, bool key) {
+				fReadString([&](char32_t cp) { str::CodepointTo<CodeError>(sink, cp, 1); }, key);
+			}
+			constexpr void matchString(detail::KeyMatcher& matcher, bool key) {
+				/* feed the decoded codepoints directly to the matcher without materializing the string */
+				fReadString([&](char32_t cp) { matcher.next(cp); }, key);
+			}
+			constexpr void skipValue() {
+				fSkipItems(1, false);
+				fConsumed();
+			}
+			constexpr void skipContainer(bool) {
+				/* skip the remaining data-items of the opened map/array without decoding them */
+				Level level = pLevels.back();
+				pLevels.pop_back();
+				fSkipItems(level.remaining, level.indefinite);
+				fConsumed();
+			}
+			constexpr bool interrupted() const {
+				return false;
+			}
+			constexpr json::Bookmark tokenBookmark() const {
+				return json::Bookmark{ pOrigin + pTokenOffset, pOrigin + pTokenOffset };
+			}
+			constexpr void setOrigin(const json::Bookmark& bookmark) {
+				pOrigin = bookmark.offset;
+			}
+			constexpr void checkDone() {
+				if (pOffset != pBytes.size())
+					throw json::DeserializeException(L"Unexpected trailing bytes encountered at byte ", pOrigin + pOffset);
+			}
+		};
+
+		template <class SinkType, char32_t CodeError>
+			requires json::IsCborSink<SinkType>
+		class Serializer<SinkType, CodeError> {
+		private:
+			std::remove_cvref_t<SinkType> pSink;
+			std::string pBuffer;
+
+		private:
+			constexpr void fHead(detail::CborMajor major, uint64_t arg) {
+				/* write the initial byte and the argument in the shortest big-endian form */
+				uint8_t buf[9] = { uint8_t(uint8_t(major) << 5), 0, 0, 0, 0, 0, 0, 0, 0 };
+				size_t size = (arg < 24 ? 0 : (arg <= 0xff ? 1 : (arg <= 0xffff ? 2 : (arg <= 0xffffffff ? 4 : 8))));
+				if (size == 0)
+					buf[0] |= uint8_t(arg);
+				else
+					buf[0] |= uint8_t(24 + (size == 1 ? 0 : (size == 2 ? 1 : (size == 4 ? 2 : 3))));
+				for (size_t i = 0; i < size; ++i)
+					buf[1 + i] = uint8_t(arg >> (8 * (size - 1 - i)));
+				pSink.write(buf, 1 + size);
+			}
+			constexpr void fByte(uint8_t byte) {
+				pSink.write(&byte, 1);
+			}
+			constexpr void fString(const auto& s) {
+				pBuffer.clear();
+				str::TranscodeAllTo<CodeError>(pBuffer, s);
+				fHead(detail::CborMajor::text, pBuffer.size());
+				pSink.write(reinterpret_cast<const uint8_t*>(pBuffer.data()), pBuffer.size());
+			}
+			constexpr void fFloat(double value) {
+				/* write the real as single-precision float, if it can be represented exactly */
+				uint8_t buf[9] = { 0 };
+				size_t size = 8;
+				if (float(value) == value || std::isnan(value)) {
+					float single = float(value);
+					uint32_t bits = 0;
+					std::memcpy(&bits, &single, sizeof(bits));
+					buf[0] = uint8_t((uint8_t(detail::CborMajor::simple) << 5) | detail::CborSingle);
+					for (size_t i = 0; i < 4; ++i)
+						buf[1 + i] = uint8_t(bits >> (8 * (3 - i)));
+					size = 4;
+				}
+				else {
+					uint64_t bits = 0;
+					std::memcpy(&bits, &value, sizeof(bits));
+					buf[0] = uint8_t((uint8_t(detail::CborMajor::simple) << 5) | detail::CborDouble);
+					for (size_t i = 0; i < 8; ++i)
+						buf[1 + i] = uint8_t(bits >> (8 * (7 - i)));
+				}
+				pSink.write(buf, 1 + size);
+			}
+
+		public:
+			constexpr Serializer(const auto& sink, const std::wstring_view&) : pSink{ sink } {}
+
+		public:
+			constexpr std::remove_cvref_t<SinkType>& sink() {
+				return pSink;
+			}
+			constexpr void primitive(const auto& v) {
+				using VType = std::remove_cvref_t<decltype(v)>;
+
+				if constexpr (std::same_as<VType, json::Bool>)
+					fByte(uint8_t((uint8_t(detail::CborMajor::simple) << 5) | (v ? detail::CborTrue : detail::CborFalse)));
+				else if constexpr (std::same_as<VType, json::Null>)
+					fByte(uint8_t((uint8_t(detail::CborMajor::simple) << 5) | detail::CborNull));
+				else if constexpr (std::floating_point<VType>)
+					fFloat(double(v));
+
+				/* write negative integers as their one's complement */
+				else if constexpr (std::integral<VType>) {
+					if constexpr (std::is_signed_v<VType>) {
+						if (v < 0) {
+							fHead(detail::CborMajor::nnum, ~uint64_t(int64_t(v)));
+							return;
+						}
+					}
+					fHead(detail::CborMajor::unum, uint64_t(v));
+				}
+				else
+					fString(v);
+			}
+			constexpr void begin(bool obj) {
+				fByte(uint8_t((uint8_t(obj ? detail::CborMajor::map : detail::CborMajor::array) << 5) | detail::CborIndefinite));
+			}
+			constexpr void objectKey(const auto& s) {
+				fString(s);
+			}
+			constexpr void arrayValue() {}
+			constexpr void arrayValues(const auto& values) {
+				for (const auto& value : values)
+					primitive(value);
+			}
+			constexpr void end(bool) {
+				fByte(detail::CborBreak);
+			}
+		};
+	}
+}
@@ -14,6 +14,13 @@
 #include <memory>
 #include <iterator>
 #include <vector>
+#include <optional>
+#include <span>
+#include <ranges>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <ios>
 
 namespace json {
 	/* primitive json-types */
@@ -60,13 +67,93 @@ namespace json {
 		constexpr ReaderException(const Args&... args) : str::BuildException{ args... } {}
 	};
 
+	/* exception thrown when a malformed json-pointer is added to a projection */
+	struct ProjectionException : public str::BuildException {
+		template <class... Args>
+		constexpr ProjectionException(const Args&... args) : str::BuildException{ args... } {}
+	};
+
+	/* exception thrown when a viewer-image cannot be written or is malformed or incompatible upon loading */
+	struct SnapshotException : public str::BuildException {
+		template <class... Args>
+		constexpr SnapshotException(const Args&... args) : str::BuildException{ args... } {}
+	};
+
+	/* exception thrown when a schema cannot be compiled or a deserialized value violates the schema */
+	struct SchemaException : public str::BuildException {
+		template <class... Args>
+		constexpr SchemaException(const Args&... args) : str::BuildException{ args... } {}
+	};
+
 	/* exception thrown when decoding or parsing of a json-string fails */
 	struct DeserializeException : public str::BuildException {
 		template <class... Args>
 		constexpr DeserializeException(const Args&... args) : str::BuildException{ args... } {}
 	};
 
+	/* id of keys, which are not part of a json::KeySet */
+	static constexpr size_t UnknownKey = size_t(-1);
+
 	namespace detail {
+		/* number of codepoints to be passed at once between the type-erased sinks/streams and the builders/readers */
+		static constexpr size_t BlockSize = 4096;
+
+		/* key of a json::KeySet with the id it was declared with */
+		struct KeyEntry {
+			json::StrView key;
+			size_t id = 0;
+		};
+
+		/* incrementally match a decoded string against the lexicographically sorted keys by narrowing
+		*	the range of candidates per string-unit (only the candidates themselves are ever compared) */
+		class KeyMatcher {
+		private:
+			std::span<const detail::KeyEntry> pKeys;
+			size_t pBegin = 0;
+			size_t pEnd = 0;
+			size_t pLength = 0;
+
+		public:
+			constexpr KeyMatcher(std::span<const detail::KeyEntry> keys) : pKeys{ keys }, pEnd{ keys.size() } {}
+
+		private:
+			constexpr void fNext(wchar_t c) {
+				/* all keys of the current range share the first pLength units, and are therefore sorted by
+				*	their next unit (keys which end at pLength are ordered first and therefore skipped) */
+				while (pBegin < pEnd && (pKeys[pBegin].key.size() <= pLength || pKeys[pBegin].key[pLength] < c))
+					++pBegin;
+				size_t end = pBegin;
+				while (end < pEnd && pKeys[end].key[pLength] == c)
+					++end;
+				pEnd = end;
+				++pLength;
+			}
+
+		public:
+			constexpr void next(char32_t cp) {
+				if (pBegin >= pEnd)
+					return;
+
+				/* feed the codepoint in the encoding of the keys (utf-16 on platforms with 2-byte wchar_t) */
+				if constexpr (sizeof(wchar_t) == 2) {
+					if (cp >= 0x10000) {
+						fNext(wchar_t(0xd800 + ((cp - 0x10000) >> 10)));
+						fNext(wchar_t(0xdc00 + ((cp - 0x10000) & 0x03ff)));
+						return;
+					}
+				}
+				fNext(wchar_t(cp));
+			}
+			constexpr size_t id() const {
+				if (pBegin < pEnd && pKeys[pBegin].key.size() == pLength)
+					return pKeys[pBegin].id;
+				return json::UnknownKey;
+			}
+			constexpr const detail::KeyEntry& entry() const {
+				return pKeys[pBegin];
+			}
+		};
+
 		template <class Type>
 		concept IsPair = requires(const Type t) {
 			{ t.first };
@@ -76,6 +163,58 @@ namespace json {
 		concept IsNotPair = !detail::IsPair<Type>;
 	}
 
+	/* compile-time set of expected object-keys, which are assigned the ids in the order of declaration
+	*	(used to dispatch the keys of objects while reading without materializing the keys) */
+	template <size_t Count>
+	class KeySet {
+	private:
+		std::array<detail::KeyEntry, Count> pKeys;
+
+	public:
+		template <class... Args>
+		constexpr KeySet(const Args&... args) requires(sizeof...(Args) == Count) {
+			size_t index = 0;
+			((pKeys[index] = detail::KeyEntry{ json::StrView{ args }, index }, ++index), ...);
+
+			/* sort the keys lexicographically (stable to ensure the first declaration wins for duplicates) */
+			for (size_t i = 1; i < Count; ++i) {
+				for (size_t j = i; j > 0 && pKeys[j].key < pKeys[j - 1].key; --j)
+					std::swap(pKeys[j], pKeys[j - 1]);
+			}
+		}
+
+	public:
+		constexpr size_t size() const {
+			return Count;
+		}
+		constexpr json::StrView operator[](size_t id) const {
+			for (const detail::KeyEntry& entry : pKeys) {
+				if (entry.id == id)
+					return entry.key;
+			}
+			throw json::RangeException(L"Key id out of range");
+		}
+		constexpr size_t id(json::StrView key) const {
+			/* binary-search the key (the first declaration of duplicate keys is ordered first) */
+			size_t begin = 0, end = Count;
+			while (begin < end) {
+				size_t mid = begin + (end - begin) / 2;
+				if (pKeys[mid].key < key)
+					begin = mid + 1;
+				else
+					end = mid;
+			}
+			if (begin < Count && pKeys[begin].key == key)
+				return pKeys[begin].id;
+			return json::UnknownKey;
+		}
+		constexpr std::span<const detail::KeyEntry> entries() const {
+			return pKeys;
+		}
+	};
+	template <class... Args>
+	KeySet(const Args&...) -> KeySet<sizeof...(Args)>;
+
 	/* check if the type is a primitive json-value [null, bool, real, number] */
 	template <class Type>
 	concept IsPrimitive = std::same_as<std::remove_cvref_t<Type>, json::Null> || std::integral<std::remove_cvref_t<Type>> || std::floating_point<std::remove_cvref_t<Type>>;
@@ -131,4 +270,49 @@ namespace json {
 	/* check if the type is any valid json-value */
 	template <class Type>
 	concept IsJson = json::IsPrimitive<Type> || json::IsString<Type> || json::IsArray<Type> || json::IsObject<Type> || json::IsValue<Type>;
+
+	/* check if the type is a container of bytes or a binary output-stream, to which binary wire-formats can be written */
+	template <class Type>
+	concept IsByteSink = requires(Type & t, const char* data, std::streamsize size) { t.write(data, size); } ||
+		(sizeof(std::ranges::range_value_t<Type>) == 1 && requires(Type & t, const uint8_t * data) { t.insert(t.end(), data, data); });
+
+	namespace detail {
+		/* specialized by the binary wire-formats to accept their sources/sinks in place of character-streams/sinks */
+		template <class Type>
+		struct BinaryInput : std::false_type {};
+		template <class Type>
+		struct BinaryOutput : std::false_type {};
+
+		template <json::IsByteSink SinkType>
+		constexpr void WriteBytes(SinkType& sink, const uint8_t* data, size_t size) {
+			if constexpr (requires(SinkType & t, const char* d, std::streamsize s) { t.write(d, s); })
+				sink.write(reinterpret_cast<const char*>(data), std::streamsize(size));
+			else
+				sink.insert(sink.end(), data, data + size);
+		}
+
+		/* encode the bytes as unpadded base64url (RFC 4648 [5]), as which binary data of the wire-formats is represented in strings */
+		constexpr void Base64Url(std::span<const uint8_t> bytes, auto&& put) {
+			const char32_t* alphabet = U"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+			for (size_t i = 0; i < bytes.size(); i += 3) {
+				uint32_t block = uint32_t(bytes[i]) << 16;
+				if (i + 1 < bytes.size())
+					block |= uint32_t(bytes[i + 1]) << 8;
+				if (i + 2 < bytes.size())
+					block |= uint32_t(bytes[i + 2]);
+
+				size_t count = std::min<size_t>(bytes.size() - i, 3) + 1;
+				for (size_t j = 0; j < count; ++j)
+					put(alphabet[(block >> (18 - 6 * j)) & 0x3f]);
+			}
+		}
+	}
+
+	/* check if the type can be read from (character-stream or source of a binary wire-format) */
+	template <class Type>
+	concept IsInput = str::IsStream<Type> || detail::BinaryInput<std::remove_cvref_t<Type>>::value;
+
+	/* check if the type can be written to (character-sink or sink of a binary wire-format) */
+	template <class Type>
+	concept IsOutput = str::IsSink<Type> || detail::BinaryOutput<std::remove_cvref_t<Type>>::value;
 }
@@ -4,6 +4,8 @@
 
 #include "json-common.h"
 #include "json-deserializer.h"
+#include "json-cbor.h"
+#include "json-msgpack.h"
 #include "json-value.h"
 
 namespace json {
@@ -11,7 +13,7 @@ namespace json {
 		template <class StreamType, char32_t CodeError>
 		class JsonDeserializer {
 		private:
-			detail::Deserializer<StreamType, CodeError> pDeserializer;
+			detail::Deserializer<StreamType, CodeError>& pDeserializer;
 
 		private:
 			constexpr void fObject(json::Obj& out) {
@@ -69,9 +71,11 @@ namespace json {
 			}
 
 		public:
-			constexpr JsonDeserializer(auto&& stream, json::Value& out) : pDeserializer{ std::forward<StreamType>(stream) } {
+			constexpr JsonDeserializer(detail::Deserializer<StreamType, CodeError>& deserializer) : pDeserializer{ deserializer } {}
+
+		public:
+			constexpr void read(json::Value& out) {
 				fValue(out);
-				pDeserializer.checkDone();
 			}
 		};
 	}
@@ -81,11 +85,13 @@ namespace json {
 	*	- expects entire stream to be a single json value until the end with optional whitespace padding
 	*	- for objects with multiple identical keys, the last occurring value will be used */
 	template <char32_t CodeError = str::err::DefChar>
-	constexpr json::Value Deserialize(str::IsStream auto&& stream) {
+	constexpr json::Value Deserialize(json::IsInput auto&& stream) {
 		using StreamType = decltype(stream);
 
+		detail::Deserializer<std::remove_reference_t<StreamType>, CodeError> deserializer{ std::forward<StreamType>(stream) };
 		json::Value out;
-		detail::JsonDeserializer<std::remove_reference_t<StreamType>, CodeError> _deserializer{ std::forward<StreamType>(stream), out };
+		detail::JsonDeserializer<std::remove_reference_t<StreamType>, CodeError>{ deserializer }.read(out);
+		deserializer.checkDone();
 		return out;
 	}
 }
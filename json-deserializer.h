@@ -5,8 +5,92 @@
 #include "json-common.h"
 
 namespace json {
+	namespace detail {
+		template <class StreamType, char32_t CodeError>
+		class Deserializer;
+	}
+
+	/* position of a value within a stream, from which it can be read again by json::ReadAt (offset is in code units of the
+	*	stream relative to the start of string-like streams or the absolute position of seekable streams, which allows the reading
+	*	to have started anywhere in the stream, while position is relative to the start of reading and used for error messages) */
+	struct Bookmark {
+		size_t offset = 0;
+		size_t position = 0;
+	};
+
+	/* caller-fed queue of utf-8 encoded bytes, which can be read by a json::Reader without blocking (the reader
+	*	reports that more input is needed, whenever the queued bytes are exhausted before the feed has been closed) */
+	class Feed {
+		template <class StreamType, char32_t CodeError>
+		friend class detail::Deserializer;
+	private:
+		std::u8string pData;
+		size_t pOffset = 0;
+		bool pClosed = false;
+
+	public:
+		Feed() = default;
+
+	private:
+		std::u8string_view fPending() const {
+			return std::u8string_view{ pData }.substr(pOffset);
+		}
+		void fConsume(size_t count) {
+			pOffset += count;
+		}
+
+	public:
+		/* append the bytes to the queue (bytes, which have already been consumed by the reader, are released) */
+		void append(std::u8string_view data) {
+			if (pClosed)
+				throw json::ReaderException(L"Feed has already been closed");
+			if (pOffset > 0) {
+				pData.erase(0, pOffset);
+				pOffset = 0;
+			}
+			pData.append(data);
+		}
+		void append(const char* data, size_t size) {
+			append(std::u8string_view{ reinterpret_cast<const char8_t*>(data), size });
+		}
+
+		/* mark the end of the input (required for the reader to detect the end of the json-value) */
+		void close() {
+			pClosed = true;
+		}
+		bool closed() const {
+			return pClosed;
+		}
+	};
+
 	/* deserialization interprets \u escape-sequences as utf-16 encoding */
 	namespace detail {
+		/* thrown by the deserializer, if a json::Feed is exhausted before being closed (the interrupted token or skip
+		*	is continued by the next read of the same kind, or the deserializer must be rolled back to a checkpoint) */
+		struct NeedsInput {};
+
+		/* state to roll the deserializer back to, if a value, which cannot be continued, is interrupted by an exhausted json::Feed */
+		struct FeedCheckpoint {
+			size_t pending = 0;
+			size_t offset = 0;
+			size_t tokenOffset = 0;
+			size_t position = 0;
+			char32_t token = 0;
+		};
+
+		enum class TokenKind : uint8_t {
+			none,
+			string,
+			number,
+			word
+		};
+		enum class StrPhase : uint8_t {
+			chars,
+			escape,
+			unicode,
+			surrogate,
+			separator
+		};
 		enum class NumState : uint8_t {
 			preSign,
 			preDigits,
@@ -20,22 +104,133 @@ namespace json {
 		};
 		using NumberValue = std::variant<json::UNum, json::INum, json::Real>;
 
+		/* progress of the token currently being read, which allows a token interrupted by an exhausted json::Feed to be continued */
+		struct TokenProgress {
+			std::u32string_view word;
+			str::Encoded<char16_t> sequence;
+			uint32_t code = 0;
+			uint8_t index = 0;
+			detail::TokenKind kind = detail::TokenKind::none;
+			detail::StrPhase phase = detail::StrPhase::chars;
+			detail::NumState number = detail::NumState::preSign;
+			bool negative = false;
+		};
+
+		/* type-erased stream, which decodes entire blocks of codepoints, to only require one virtual call per block */
+		struct BlockSource {
+			virtual ~BlockSource() = default;
+
+			/* fill the buffer with up to size codepoints and return the number of codepoints written (zero if the end has been reached) */
+			virtual size_t read(char32_t* buffer, size_t size) = 0;
+		};
+
 		template <class StreamType, char32_t CodeError>
-		class Deserializer {
+		class BlockSourceImpl final : public detail::BlockSource {
 			using ChType = str::StreamChar<StreamType>;
 		private:
 			str::Stream<StreamType> pStream;
+
+		public:
+			template <class Type>
+			constexpr BlockSourceImpl(Type&& s) : pStream{ std::forward<Type>(s) } {}
+
+		public:
+			size_t read(char32_t* buffer, size_t size) override {
+				size_t count = 0;
+				while (count < size && !pStream.done()) {
+					/* fetch the next codepoint and skip all codepoints to be ignored (due to CodeError) */
+					auto [cp, len] = str::GetCodepoint<CodeError>(pStream.load(str::MaxEncSize<ChType>));
+					pStream.consume(len);
+					if (cp != str::Invalid)
+						buffer[count++] = cp;
+
+					/* check if the stream ends within a codepoint (only report it once all previous codepoints have been consumed) */
+					else if (len == 0) {
+						if (count > 0)
+							break;
+						throw json::DeserializeException(L"Unexpected <EOF> encountered within an encoded codepoint");
+					}
+				}
+				return count;
+			}
+		};
+
+		template <class StreamType, char32_t CodeError>
+		class Deserializer {
+		private:
+			/* type-erased streams are read in blocks and only their local buffer is decoded */
+			static constexpr bool IsBlock = std::is_same_v<std::remove_cvref_t<StreamType>, std::unique_ptr<detail::BlockSource>>;
+
+			/* caller-fed streams are referenced and report their exhaustion instead of blocking */
+			static constexpr bool IsFeed = std::is_same_v<std::remove_cvref_t<StreamType>, json::Feed>;
+			using ActStream = std::conditional_t<IsBlock, std::unique_ptr<detail::BlockSource>, std::conditional_t<IsFeed, json::Feed&, str::Stream<StreamType>>>;
+
+		private:
+			size_t pOffset = 0;
+			ActStream pStream;
 			std::u32string pBuffer;
+			std::u32string pBlock;
+			std::u32string pNesting;
+			detail::TokenProgress pToken;
+			size_t pBlockOffset = 0;
 			size_t pPosition = 0;
+			size_t pTokenOffset = 0;
 			char32_t pLastToken = str::Invalid;
+			bool pSkipString = false;
+			bool pSkipEscape = false;
+			bool pSkipping = false;
 
 		public:
 			template <class Type>
-			constexpr Deserializer(Type&& s) : pStream{ std::forward<Type>(s) } {}
+			constexpr Deserializer(Type&& s) : pOffset{ fStreamStart(s) }, pStream{ std::forward<Type>(s) } {}
 
 		private:
+			static constexpr size_t fStreamStart(auto& s) {
+				/* count the offsets of seekable streams from their current position, which allows the bookmarks
+				*	to be sought directly, even if the reading did not start at the beginning of the stream */
+				if constexpr (requires { s.tellg(); }) {
+					auto start = s.tellg();
+					if (start > 0)
+						return size_t(start);
+				}
+				return 0;
+			}
 			template <bool AllowEndOfStream>
 			constexpr char32_t fPrepare() {
+				if constexpr (IsBlock)
+					return fPrepareBlock<AllowEndOfStream>();
+				else if constexpr (IsFeed)
+					return fPrepareFeed<AllowEndOfStream>();
+				else
+					return fPrepareStream<AllowEndOfStream>();
+			}
+			template <bool AllowEndOfStream>
+			constexpr bool fFetchBlock() {
+				/* check if the next block needs to be fetched */
+				if (pBlockOffset < pBlock.size())
+					return true;
+				pBlock.resize(detail::BlockSize);
+				pBlock.resize(pStream->read(pBlock.data(), pBlock.size()));
+				pBlockOffset = 0;
+
+				/* check if the EOF has been reached */
+				if (!pBlock.empty())
+					return true;
+				if (AllowEndOfStream)
+					return false;
+				throw json::DeserializeException(L"Unexpected <EOF> encountered at ", pPosition);
+			}
+			template <bool AllowEndOfStream>
+			constexpr char32_t fPrepareBlock() {
+				if (!fFetchBlock<AllowEndOfStream>())
+					return str::Invalid;
+				pTokenOffset = pOffset++;
+				return (pLastToken = pBlock[pBlockOffset++]);
+			}
+			template <bool AllowEndOfStream>
+			constexpr char32_t fPrepareStream() {
+				using ChType = str::StreamChar<StreamType>;
+
 				while (true) {
 					if (AllowEndOfStream && pStream.done())
 						return str::Invalid;
@@ -43,14 +238,40 @@ namespace json {
 					/* fetch the next codepoint and skip all codepoints to be ignored (due to CodeError) */
 					auto [cp, len] = str::GetCodepoint<CodeError>(pStream.load(str::MaxEncSize<ChType>));
 					pStream.consume(len);
-					if (cp != str::Invalid)
+					pOffset += len;
+					if (cp != str::Invalid) {
+						pTokenOffset = pOffset - len;
 						return (pLastToken = cp);
+					}
 
 					/* check if the EOF has been reached */
 					if (len == 0)
 						throw json::DeserializeException(L"Unexpected <EOF> encountered at ", pPosition);
 				}
 			}
+			template <bool AllowEndOfStream>
+			constexpr char32_t fPrepareFeed() {
+				while (true) {
+					/* fetch the next codepoint and skip all codepoints to be ignored (due to CodeError) */
+					std::u8string_view pending = pStream.fPending();
+					auto [cp, len] = str::GetCodepoint<CodeError>(pending);
+					pStream.fConsume(len);
+					pOffset += len;
+					if (cp != str::Invalid) {
+						pTokenOffset = pOffset - len;
+						return (pLastToken = cp);
+					}
+					if (len != 0)
+						continue;
+
+					/* check if more input can still be fed or if the EOF has been reached */
+					if (!pStream.closed())
+						throw detail::NeedsInput{};
+					if (AllowEndOfStream && pending.empty())
+						return str::Invalid;
+					throw json::DeserializeException(L"Unexpected <EOF> encountered at ", pPosition);
+				}
+			}
 			constexpr void fConsume() {
 				++pPosition;
 				pLastToken = str::Invalid;
@@ -64,16 +285,12 @@ namespace json {
 				/* skip any leading whitespace */
 				if (skipWhiteSpace) {
 					while (pLastToken == U' ' || pLastToken == U'\n' || pLastToken == U'\r' || pLastToken == U'\t') {
-						++pPosition;
+						fConsume();
 						pLastToken = fPrepare<AllowEndOfStream>();
 					}
 				}
 				return pLastToken;
 			}
-			constexpr char32_t fConsumeAndNext(bool skipWhiteSpace) {
-				fConsume();
-				return fNextToken(skipWhiteSpace);
-			}
 
 		private:
 			constexpr void fUnexpectedToken(char32_t token, const char8_t* expected) {
@@ -84,14 +301,292 @@ namespace json {
 			constexpr void fParseError(const char8_t* what) {
 				throw json::DeserializeException(what, L" while parsing the json at ", pPosition);
 			}
-			constexpr void fCheckWord(const std::u32string_view& word) {
-				/* verify the remaining characters (first character is already verified to determine the type) */
-				for (size_t i = 1; i < word.size(); ++i) {
-					char32_t c = fConsumeAndNext(false);
-					if (c != word[i])
-						fUnexpectedToken(c, str::u8::Format(u8"[{}] of [{}]", c, word).c_str());
+			constexpr detail::NumState fScanNumber(bool& neg) {
+				/* setup the scan, unless an interrupted number is being continued (scanned characters remain in the buffer) */
+				if (pToken.kind != detail::TokenKind::number) {
+					pBuffer.clear();
+					pToken.kind = detail::TokenKind::number;
+					pToken.number = detail::NumState::preSign;
+					pToken.negative = false;
 				}
-				fConsume();
+				detail::NumState& state = pToken.number;
+
+				/* verify the number, according to the json-number format */
+				while (true) {
+					/* numbers are not terminated by a token and may therefore end at the end of the stream */
+					char32_t c = fNextToken<true>(false);
+
+					/* update the state-machine */
+					if (c == '-' && (state == NumState::preSign || state == NumState::preExpSign)) {
+						if (state == NumState::preSign)
+							pToken.negative = true;
+						state = (state == NumState::preSign) ? NumState::preDigits : NumState::preExponent;
+					}
+					else if (c == '+' && state == NumState::preExpSign)
+						state = NumState::preExponent;
+					else if (c == '.' && (state == NumState::inDigits || state == NumState::postDigits))
+						state = NumState::preFraction;
+					else if ((c == 'e' || c == 'E') && (state == NumState::inDigits || state == NumState::postDigits || state == NumState::inFraction))
+						state = NumState::preExpSign;
+					else if (c >= '0' && c <= '9' && state != NumState::postDigits) {
+						if (state == NumState::preSign || state == NumState::preDigits)
+							state = (c == '0') ? NumState::postDigits : NumState::inDigits;
+						else if (state == NumState::preFraction)
+							state = NumState::inFraction;
+						else if (state == NumState::preExpSign || state == NumState::preExponent)
+							state = NumState::inExponent;
+					}
+					else
+						break;
+
+					/* consume the character and add it to the buffer and fetch the next character to be checked */
+					pBuffer.push_back(c);
+					fConsume();
+				}
+				pToken.kind = detail::TokenKind::none;
+				neg = pToken.negative;
+
+				/* check if a valid final state has been entered */
+				if (state == NumState::preSign || state == NumState::preDigits || state == NumState::preFraction || state == NumState::preExpSign || state == NumState::preExponent)
+					fParseError(u8"Malformed json number encountered");
+				return state;
+			}
+			constexpr void fReadString(auto&& put, bool key) {
+				/* validate the opening quotation mark, unless an interrupted string is being continued */
+				if (pToken.kind != detail::TokenKind::string) {
+					char32_t c = fNextToken(true);
+					if (c != U'\"') {
+						fUnexpectedToken(c, u8"[\"] as start of a string");
+						return;
+					}
+					fConsume();
+					pToken.kind = detail::TokenKind::string;
+					pToken.phase = detail::StrPhase::chars;
+				}
+
+				/* read the tokens until the closing quotation mark is encountered (the progress within escape-sequences
+				*	is kept in the token-state, as each token is consumed before the next token is fetched) */
+				while (true) {
+					char32_t c = fNextToken(pToken.phase == detail::StrPhase::separator);
+
+					switch (pToken.phase) {
+					case detail::StrPhase::chars:
+						/* check if the end has been encountered and consume the ending character */
+						if (c == U'\"') {
+							fConsume();
+							if (!key) {
+								pToken.kind = detail::TokenKind::none;
+								return;
+							}
+							pToken.phase = detail::StrPhase::separator;
+							break;
+						}
+
+						/* check if the token is wellformed and not an escape-sequence */
+						if (cp::prop::IsControl(c)) {
+							fParseError(u8"Control characters in string encountered");
+							return;
+						}
+						fConsume();
+						if (c == U'\\')
+							pToken.phase = detail::StrPhase::escape;
+						else
+							put(c);
+						break;
+					case detail::StrPhase::escape:
+						/* unpack the escape sequence */
+						switch (c) {
+						case U'\"':
+						case U'\\':
+						case U'/':
+							break;
+						case U'b':
+							c = U'\b';
+							break;
+						case U'f':
+							c = U'\f';
+							break;
+						case U'n':
+							c = U'\n';
+							break;
+						case U'r':
+							c = U'\r';
+							break;
+						case U't':
+							c = U'\t';
+							break;
+						case U'u':
+							/* setup the potential utf-16 encoded \u escape sequence */
+							fConsume();
+							pToken.phase = detail::StrPhase::unicode;
+							pToken.sequence = str::Encoded<char16_t>{};
+							pToken.index = 0;
+							pToken.code = 0;
+							continue;
+						default:
+							fParseError(u8"Unknown escape-sequence in string encountered");
+							return;
+						}
+						fConsume();
+						put(c);
+						pToken.phase = detail::StrPhase::chars;
+						break;
+					case detail::StrPhase::unicode: {
+						/* decode the unicode character */
+						uint32_t val = uint32_t(cp::ascii::GetRadix(c));
+						if (val >= 16)
+							fParseError(u8"Invalid [\\u] escape-sequence in string encountered");
+						fConsume();
+						pToken.code = (pToken.code << 4) + val;
+						if (++pToken.index < 4)
+							break;
+						pToken.sequence.push_back(char16_t(pToken.code));
+
+						/* try to decode the character or check if another character is
+						*	missing (cannot result in incomplete if max_size is encountered) */
+						auto [cp, len] = str::PartialCodepoint<CodeError>(pToken.sequence);
+						if (len != 0) {
+							pToken.phase = detail::StrPhase::chars;
+							if (cp != str::Invalid)
+								put(cp);
+						}
+						else {
+							pToken.phase = detail::StrPhase::surrogate;
+							pToken.index = 0;
+						}
+						break;
+					}
+					case detail::StrPhase::surrogate:
+						/* check for the next \u escape-sequence (validated once both characters have been fetched) */
+						if (pToken.index++ == 0) {
+							pToken.code = (c == U'\\' ? 1 : 0);
+							fConsume();
+							break;
+						}
+						if (pToken.code == 0 || c != U'u')
+							fParseError(u8"Invalid [\\u] utf-16 surrogate-pair in string encountered");
+						fConsume();
+						pToken.phase = detail::StrPhase::unicode;
+						pToken.index = 0;
+						pToken.code = 0;
+						break;
+					case detail::StrPhase::separator:
+						/* validate the key-separation */
+						if (c != U':')
+							fUnexpectedToken(c, u8"[:] object-separator");
+						fConsume();
+						pToken.kind = detail::TokenKind::none;
+						return;
+					}
+				}
+			}
+			template <class ChType>
+			static constexpr bool fContinuation(char32_t c) {
+				/* check if the unit continues an encoded codepoint (positions only count the lead units of codepoints) */
+				if constexpr (sizeof(ChType) == 1)
+					return ((c & 0xc0) == 0x80);
+				else if constexpr (sizeof(ChType) == 2)
+					return (c >= 0xdc00 && c <= 0xdfff);
+				else
+					return false;
+			}
+			template <class ChType>
+			constexpr bool fSkipChunk(const std::basic_string_view<ChType>& chunk, size_t& consumed, size_t& codepoints) {
+				/* only track the nesting and the strings (structural characters are always ascii, and ascii
+				*	characters cannot occur within any other encoded codepoint, therefore no decoding is required) */
+				codepoints = 0;
+				for (consumed = 0; consumed < chunk.size(); ++consumed) {
+					char32_t c = char32_t(std::make_unsigned_t<ChType>(chunk[consumed]));
+					if (!fContinuation<ChType>(c))
+						++codepoints;
+
+					/* check if the end of the string has been reached */
+					if (pSkipString) {
+						if (pSkipEscape)
+							pSkipEscape = false;
+						else if (c == U'\\')
+							pSkipEscape = true;
+						else if (c == U'\"')
+							pSkipString = false;
+						else if (c < U' ') {
+							pPosition += codepoints - 1;
+							fParseError(u8"Control characters in string encountered");
+						}
+						continue;
+					}
+
+					switch (c) {
+					case U'\"':
+						pSkipString = true;
+						break;
+					case U'[':
+						pNesting.push_back(U']');
+						break;
+					case U'{':
+						pNesting.push_back(U'}');
+						break;
+					case U']':
+					case U'}':
+						if (pNesting.back() != c) {
+							pPosition += codepoints - 1;
+							fUnexpectedToken(c, pNesting.back() == U'}' ? u8"closing object-bracket" : u8"closing array-bracket");
+						}
+						pNesting.pop_back();
+
+						/* check if the value has been skipped entirely */
+						if (pNesting.empty()) {
+							++consumed;
+							return true;
+						}
+						break;
+					case U' ':
+					case U'\n':
+					case U'\r':
+					case U'\t':
+					case U',':
+					case U':':
+					case U'-':
+					case U'+':
+					case U'.':
+					case U'e':
+					case U'E':
+					case U't':
+					case U'r':
+					case U'u':
+					case U'f':
+					case U'a':
+					case U'l':
+					case U's':
+					case U'n':
+						break;
+					default:
+						if (c < U'0' || c > U'9') {
+							pPosition += codepoints - 1;
+							fUnexpectedToken(c, u8"json-value");
+						}
+						break;
+					}
+				}
+				return false;
+			}
+			constexpr void fCheckWord(std::u32string_view word) {
+				/* consume the first character, which is already verified to determine the type, unless an interrupted word is being continued */
+				if (pToken.kind != detail::TokenKind::word) {
+					fConsume();
+					pToken.kind = detail::TokenKind::word;
+					pToken.word = word;
+					pToken.index = 1;
+				}
+
+				/* verify the remaining characters */
+				while (pToken.index < pToken.word.size()) {
+					char32_t c = fNextToken(false);
+					if (c != pToken.word[pToken.index])
+						fUnexpectedToken(c, str::u8::Format(u8"[{}] of [{}]", c, pToken.word).c_str());
+					fConsume();
+					++pToken.index;
+				}
+				pToken.kind = detail::TokenKind::none;
 			}
 
 		public:
@@ -115,6 +610,14 @@ namespace json {
 				return true;
 			}
 			constexpr json::Type peekOrOpenNext() {
+				/* check if a token has been interrupted, in which case its type is already known and it is continued by the corresponding read */
+				if (pToken.kind == detail::TokenKind::string)
+					return json::Type::string;
+				if (pToken.kind == detail::TokenKind::number)
+					return json::Type::inumber;
+				if (pToken.kind == detail::TokenKind::word)
+					return (pToken.word[0] == U'n' ? json::Type::null : json::Type::boolean);
+
 				/* fetch the next token */
 				char32_t c = fNextToken(true);
 
@@ -145,56 +648,18 @@ namespace json {
 				return json::Null();
 			}
 			constexpr json::Bool readBoolean() {
-				if (fNextToken(false) == 't') {
-					fCheckWord(U"true");
-					return json::Bool(true);
-				}
-				fCheckWord(U"false");
-				return json::Bool(false);
+				/* the word of an interrupted boolean has already been determined */
+				std::u32string_view word = pToken.word;
+				if (pToken.kind != detail::TokenKind::word)
+					word = (fNextToken(false) == U't' ? U"true" : U"false");
+				fCheckWord(word);
+				return json::Bool(word.size() == 4);
 			}
 			constexpr detail::NumberValue readNumber() {
-				detail::NumState state = detail::NumState::preSign;
 				bool neg = false;
+				detail::NumState state = fScanNumber(neg);
 
-				/* verify the number, according to the json-number format */
-				pBuffer.clear();
-				while (true) {
-					char32_t c = fNextToken(false);
-
-					/* update the state-machine */
-					if (c == '-' && (state == NumState::preSign || state == NumState::preExpSign)) {
-						if (state == NumState::preSign)
-							neg = true;
-						state = (state == NumState::preSign) ? NumState::preDigits : NumState::preExponent;
-					}
-					else if (c == '+' && state == NumState::preExpSign)
-						state = NumState::preExponent;
-					else if (c == '.' && (state == NumState::inDigits || state == NumState::postDigits))
-						state = NumState::preFraction;
-					else if ((c == 'e' || c == 'E') && (state == NumState::inDigits || state == NumState::postDigits || state == NumState::inFraction))
-						state = NumState::preExpSign;
-					else if (c >= '0' && c <= '9' && state != NumState::postDigits) {
-						if (state == NumState::preSign || state == NumState::preDigits)
-							state = (c == '0') ? NumState::postDigits : NumState::inDigits;
-						else if (state == NumState::preFraction)
-							state = NumState::inFraction;
-						else if (state == NumState::preExpSign || state == NumState::preExponent)
-							state = NumState::inExponent;
-					}
-					else
-						break;
-
-					/* consume the character and add it to the buffer and fetch the next character to be checked */
-					pBuffer.push_back(c);
-					fConsume();
-				}
-
-				/* check if a valid final state has been entered */
 				detail::NumberValue value = json::UNum(0);
-				if (state == NumState::preSign || state == NumState::preDigits || state == NumState::preFraction || state == NumState::preExpSign || state == NumState::preExponent) {
-					fParseError(u8"Malformed json number encountered");
-					return value;
-				}
 
 				/* try to parse the number as integer (if its out-of-range for ints, parse it again as real) */
 				str::ParsedNum result;
@@ -217,106 +682,166 @@ namespace json {
 				return value;
 			}
 			constexpr void readString(auto& sink, bool key) {
-				/* validate the opening quotation mark */
-				char32_t c = fNextToken(true);
-				if (c != U'\"') {
-					fUnexpectedToken(c, u8"[\"] as start of a string");
-					return;
-				}
+				fReadString([&](char32_t cp) { str::CodepointTo<CodeError>(sink, cp, 1); }, key);
+			}
+			template <class ChType>
+			constexpr bool readVerbatim(std::basic_string_view<ChType> source, std::basic_string<ChType>& sink, size_t& offset, size_t& length, bool key) requires(!IsBlock && !IsFeed) {
+				/* check if the string is contained verbatim in the source, which is being deserialized (no escape-sequences or invalid encodings), and return
+				*	its offset/length in the source, otherwise decode it to the sink and return its offset/length in the sink (current token is the quotation mark) */
+				fNextToken(true);
+				size_t start = pOffset, next = pOffset, begin = sink.size();
+				bool verbatim = true;
+
+				fReadString([&](char32_t cp) {
+					if (verbatim && pTokenOffset == next) {
+						/* codepoints equal to the error-codepoint might be replacements of invalid encodings */
+						bool valid = true;
+						if (cp == CodeError) {
+							auto [actual, len] = str::GetCodepoint<str::err::Skip>(source.substr(pTokenOffset, pOffset - pTokenOffset));
+							valid = (actual == cp);
+						}
+						if (valid) {
+							next = pOffset;
+							return;
+						}
+					}
 
-				/* read the tokens until the closing quotation mark is encountered */
-				while (true) {
-					c = fConsumeAndNext(false);
+					/* copy the verbatim prefix to the sink and decode the remainder of the string */
+					if (verbatim)
+						sink.append(source.substr(start, next - start));
+					verbatim = false;
+					str::CodepointTo<CodeError>(sink, cp, 1);
+				}, key);
 
-					/* check if the end has been encountered and consume the ending character */
-					if (c == U'\"') {
+				if (verbatim) {
+					offset = start;
+					length = next - start;
+				}
+				else {
+					offset = begin;
+					length = sink.size() - begin;
+				}
+				return verbatim;
+			}
+			constexpr void matchString(detail::KeyMatcher& matcher, bool key) {
+				/* feed the decoded codepoints directly to the matcher without materializing the string */
+				fReadString([&](char32_t cp) { matcher.next(cp); }, key);
+			}
+			constexpr void skipValue() {
+				/* skip the next value without materializing it (numbers are only scanned but not parsed), or
+				*	continue the skip of the value, if it has been interrupted by an exhausted json::Feed */
+				if (pSkipping) {
+					skipContainer(false);
+					return;
+				}
+				bool neg = false;
+				switch (peekOrOpenNext()) {
+				case json::Type::object:
+					skipContainer(true);
+					break;
+				case json::Type::array:
+					skipContainer(false);
+					break;
+				case json::Type::string:
+					fReadString([](char32_t) {}, false);
+					break;
+				case json::Type::inumber:
+					fScanNumber(neg);
+					break;
+				case json::Type::boolean:
+					readBoolean();
+					break;
+				default:
+					readNull();
+					break;
+				}
+			}
+			constexpr void skipContainer(bool obj) {
+				/* skip the remainder of the opened object/array without decoding any strings or numbers
+				*	(only validates the nesting and the termination of the strings but not the grammar) */
+				size_t consumed = 0, codepoints = 0;
+
+				/* check if a skip, which has been interrupted by an exhausted json::Feed, is being resumed */
+				if (!pSkipping) {
+					pNesting.assign(1, obj ? U'}' : U']');
+
+					/* skip the remainder of an interrupted string (all other interrupted tokens only consist of characters, which are valid for the skip) */
+					bool string = (pToken.kind == detail::TokenKind::string && pToken.phase != detail::StrPhase::separator);
+					pSkipString = string;
+					pSkipEscape = (string && (pToken.phase == detail::StrPhase::escape || (pToken.phase == detail::StrPhase::surrogate && pToken.index == 1 && pToken.code == 1)));
+					pToken.kind = detail::TokenKind::none;
+
+					/* process the already fetched token */
+					if (pLastToken != str::Invalid) {
+						char32_t c = pLastToken;
 						fConsume();
-
-						/* check if the key-separation is required */
-						if (!key)
+						if (fSkipChunk(std::u32string_view{ &c, 1 }, consumed, codepoints))
 							return;
-						c = fNextToken(true);
-						if (c != U':')
-							fUnexpectedToken(c, u8"[:] object-separator");
-						else
-							fConsume();
-						return;
 					}
+				}
 
-					/* check if the token is wellformed and not an escape-sequence */
-					if (cp::prop::IsControl(c)) {
-						fParseError(u8"Control characters in string encountered");
-						return;
+				/* process the remaining characters in chunks */
+				while (true) {
+					bool done = false;
+					if constexpr (IsBlock) {
+						fFetchBlock<false>();
+						done = fSkipChunk(std::u32string_view{ pBlock }.substr(pBlockOffset), consumed, codepoints);
+						pBlockOffset += consumed;
 					}
-					if (c != U'\\') {
-						str::CodepointTo<CodeError>(sink, c, 1);
-						continue;
+					else if constexpr (IsFeed) {
+						std::u8string_view chunk = pStream.fPending();
+						if (chunk.empty()) {
+							if (pStream.closed())
+								throw json::DeserializeException(L"Unexpected <EOF> encountered at ", pPosition);
+
+							/* keep the progress to resume the skip once more input has been fed */
+							pSkipping = true;
+							throw detail::NeedsInput{};
+						}
+						done = fSkipChunk(chunk, consumed, codepoints);
+						pStream.fConsume(consumed);
 					}
-
-					/* unpack the escape sequence */
-					c = fConsumeAndNext(false);
-					switch (c) {
-					case U'\"':
-					case U'\\':
-					case U'/':
-						str::CodepointTo<CodeError>(sink, c, 1);
-						break;
-					case U'b':
-						str::CodepointTo<CodeError>(sink, U'\b', 1);
-						break;
-					case U'f':
-						str::CodepointTo<CodeError>(sink, U'\f', 1);
-						break;
-					case U'n':
-						str::CodepointTo<CodeError>(sink, U'\n', 1);
-						break;
-					case U'r':
-						str::CodepointTo<CodeError>(sink, U'\r', 1);
-						break;
-					case U't':
-						str::CodepointTo<CodeError>(sink, U'\t', 1);
-						break;
-					case U'u':
-						break;
-					default:
-						fParseError(u8"Unknown escape-sequence in string encountered");
-						return;
+					else {
+						auto chunk = pStream.load(detail::BlockSize);
+						if (chunk.empty())
+							throw json::DeserializeException(L"Unexpected <EOF> encountered at ", pPosition);
+						done = fSkipChunk(chunk, consumed, codepoints);
+						pStream.consume(consumed);
 					}
-					if (c != U'u')
-						continue;
-
-					/* parse the potential utf-16 encoded \u escape sequence */
-					str::Encoded<char16_t> sequence;
-					for (size_t i = 0; i < sequence.max_size(); ++i) {
-						uint32_t num = 0;
-
-						/* decode the unicode character */
-						for (size_t j = 0; j < 4; j++) {
-							c = fConsumeAndNext(false);
-							uint32_t val = uint32_t(cp::ascii::GetRadix(c));
-							if (val >= 16)
-								fParseError(u8"Invalid [\\u] escape-sequence in string encountered");
-							num = (num << 4) + val;
-						}
-						sequence.push_back(char16_t(num));
-
-						/* try to decode the character or check if another character is
-						*	missing (cannot result in incomplete if max_size is encountered) */
-						auto [cp, len] = str::PartialCodepoint<CodeError>(sequence);
-						if (len != 0) {
-							if (cp != str::Invalid)
-								str::CodepointTo<CodeError>(sink, cp, 1);
-							break;
-						}
-
-						/* check for the next \u escape-sequence */
-						char32_t c0 = fConsumeAndNext(false);
-						char32_t c1 = fConsumeAndNext(false);
-						if (c0 != U'\\' || c1 != U'u')
-							fParseError(u8"Invalid [\\u] utf-16 surrogate-pair in string encountered");
+					pPosition += codepoints;
+					pOffset += consumed;
+					if (done) {
+						pSkipping = false;
+						return;
 					}
 				}
 			}
+			constexpr bool interrupted() const {
+				/* check if a token or skip has been interrupted by an exhausted json::Feed and is continued by the next read */
+				return (pSkipping || pToken.kind != detail::TokenKind::none);
+			}
+			constexpr json::Bookmark tokenBookmark() const {
+				/* bookmark of the last fetched token (already consumed tokens have advanced the position) */
+				return json::Bookmark{ pTokenOffset, (pLastToken == str::Invalid ? pPosition - 1 : pPosition) };
+			}
+			constexpr void setOrigin(const json::Bookmark& bookmark) {
+				/* continue the offsets and positions of a previous read to keep bookmarks and errors consistent */
+				pOffset = bookmark.offset;
+				pPosition = bookmark.position;
+			}
+			constexpr detail::FeedCheckpoint checkpoint() const requires(IsFeed) {
+				return detail::FeedCheckpoint{ pStream.pOffset, pOffset, pTokenOffset, pPosition, pLastToken };
+			}
+			constexpr void rollback(const detail::FeedCheckpoint& checkpoint) requires(IsFeed) {
+				/* the fed bytes are only released once new bytes are appended, and can therefore be read again */
+				pStream.pOffset = checkpoint.pending;
+				pOffset = checkpoint.offset;
+				pTokenOffset = checkpoint.tokenOffset;
+				pPosition = checkpoint.position;
+				pLastToken = checkpoint.token;
+				pToken.kind = detail::TokenKind::none;
+				pSkipping = false;
+			}
 			constexpr void checkDone() {
 				/* check if the stream is done or only consists of whitespace */
 				char32_t c = fNextToken<true>(true);
@@ -0,0 +1,556 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include "json-common.h"
+#include "json-deserializer.h"
+#include "json-serializer.h"
+
+namespace json {
+	/* messagepack-encoded bytes, which can be passed to json::Read/json::View/json::ViewUtf8/json::Deserialize/json::Project in place
+	*	of a character-stream, and which are decoded to the same json-values (the bytes are referenced and must outlive the reading)
+	*	- json::ViewUtf8 references the str-payloads directly in the bytes without decoding or copying them
+	*	- bin- and ext-payloads are converted to base64url-encoded strings (the ext-type is dropped)
+	*	- only strings are supported as object-keys */
+	class MsgPackSource {
+	private:
+		std::span<const uint8_t> pBytes;
+
+	public:
+		constexpr MsgPackSource() = default;
+		constexpr MsgPackSource(std::span<const uint8_t> bytes) : pBytes{ bytes } {}
+		MsgPackSource(std::string_view bytes) : pBytes{ reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size() } {}
+
+	public:
+		constexpr std::span<const uint8_t> bytes() const {
+			return pBytes;
+		}
+	};
+
+	/* reference to a byte-sink, which can be passed to json::Build/json::SerializeTo in place of a character-sink, to write the values
+	*	messagepack-encoded to the sink (as messagepack requires the sizes of arrays and objects upfront, all values are collected
+	*	until the outermost array or object has been completed, reals are written as float32, if they can be represented exactly)
+	*	Note: Must not outlive the sink as it stores a reference to it */
+	template <json::IsByteSink SinkType>
+	class MsgPackSink {
+	private:
+		SinkType* pSink = nullptr;
+
+	public:
+		constexpr MsgPackSink(SinkType& sink) : pSink{ &sink } {}
+
+	public:
+		constexpr void write(const uint8_t* data, size_t size) {
+			detail::WriteBytes(*pSink, data, size);
+		}
+	};
+
+	namespace detail {
+		template <class Type>
+		struct MsgPackSinkCheck : std::false_type {};
+		template <class SinkType>
+		struct MsgPackSinkCheck<json::MsgPackSink<SinkType>> : std::true_type {};
+
+		template <>
+		struct BinaryInput<json::MsgPackSource> : std::true_type {};
+		template <class SinkType>
+		struct BinaryOutput<json::MsgPackSink<SinkType>> : std::true_type {};
+	}
+
+	/* check if the type is messagepack-encoded input or output */
+	template <class Type>
+	concept IsMsgPackSource = std::is_same_v<std::remove_cvref_t<Type>, json::MsgPackSource>;
+	template <class Type>
+	concept IsMsgPackSink = detail::MsgPackSinkCheck<std::remove_cvref_t<Type>>::value;
+
+	namespace detail {
+		/* type-bytes of messagepack (fix-types encode their value/size in the lower bits) */
+		static constexpr uint8_t MsgPackFixMap = 0x80;
+		static constexpr uint8_t MsgPackFixArray = 0x90;
+		static constexpr uint8_t MsgPackFixStr = 0xa0;
+		static constexpr uint8_t MsgPackNil = 0xc0;
+		static constexpr uint8_t MsgPackNever = 0xc1;
+		static constexpr uint8_t MsgPackFalse = 0xc2;
+		static constexpr uint8_t MsgPackTrue = 0xc3;
+		static constexpr uint8_t MsgPackBin8 = 0xc4;
+		static constexpr uint8_t MsgPackExt8 = 0xc7;
+		static constexpr uint8_t MsgPackFloat32 = 0xca;
+		static constexpr uint8_t MsgPackFloat64 = 0xcb;
+		static constexpr uint8_t MsgPackUInt8 = 0xcc;
+		static constexpr uint8_t MsgPackInt8 = 0xd0;
+		static constexpr uint8_t MsgPackFixExt1 = 0xd4;
+		static constexpr uint8_t MsgPackStr8 = 0xd9;
+		static constexpr uint8_t MsgPackArray16 = 0xdc;
+		static constexpr uint8_t MsgPackMap16 = 0xde;
+		static constexpr uint8_t MsgPackNegFixInt = 0xe0;
+
+		template <class StreamType, char32_t CodeError>
+			requires json::IsMsgPackSource<StreamType>
+		class Deserializer<StreamType, CodeError> {
+		private:
+			/* remaining values of the opened containers (keys and values of maps are counted separately,
+			*	which allows the containers to be skipped at any point without relying on the separators) */
+			std::span<const uint8_t> pBytes;
+			std::vector<uint64_t> pLevels;
+			size_t pOffset = 0;
+			size_t pTokenOffset = 0;
+			size_t pOrigin = 0;
+
+		public:
+			constexpr Deserializer(const json::MsgPackSource& s) : pBytes{ s.bytes() } {}
+
+		private:
+			constexpr void fParseError(const char8_t* what) {
+				throw json::DeserializeException(what, L" while parsing the messagepack at byte ", pOrigin + pTokenOffset);
+			}
+			constexpr void fEnsure(uint64_t count) {
+				if (pBytes.size() - pOffset < count)
+					throw json::DeserializeException(L"Unexpected <EOF> encountered at byte ", pOrigin + pBytes.size());
+			}
+			constexpr uint8_t fPeekByte() {
+				fEnsure(1);
+				pTokenOffset = pOffset;
+				return pBytes[pOffset];
+			}
+			constexpr uint64_t fReadUInt(size_t size) {
+				/* read the big-endian unsigned integer */
+				fEnsure(size);
+				uint64_t value = 0;
+				for (size_t i = 0; i < size; ++i)
+					value = (value << 8) | pBytes[pOffset++];
+				return value;
+			}
+			constexpr std::span<const uint8_t> fPayload(uint64_t size) {
+				fEnsure(size);
+				std::span<const uint8_t> out = pBytes.subspan(pOffset, size_t(size));
+				pOffset += size_t(size);
+				return out;
+			}
+			constexpr std::pair<std::span<const uint8_t>, bool> fStringHead(bool key) {
+				/* read the header of the str/bin/ext and return its payload and whether it is a str */
+				uint8_t type = fPeekByte();
+				++pOffset;
+				if ((type & 0xe0) == detail::MsgPackFixStr)
+					return { fPayload(type & 0x1f), true };
+				if (type >= detail::MsgPackStr8 && type < detail::MsgPackArray16)
+					return { fPayload(fReadUInt(size_t(1) << (type - detail::MsgPackStr8))), true };
+				if (type >= detail::MsgPackBin8 && type < detail::MsgPackExt8)
+					return { fPayload(fReadUInt(size_t(1) << (type - detail::MsgPackBin8))), false };
+
+				/* skip the ext-type, as only the payload is represented */
+				if (type >= detail::MsgPackExt8 && type < detail::MsgPackFloat32) {
+					uint64_t size = fReadUInt(size_t(1) << (type - detail::MsgPackExt8));
+					fPayload(1);
+					return { fPayload(size), false };
+				}
+				if (type >= detail::MsgPackFixExt1 && type < detail::MsgPackStr8) {
+					fPayload(1);
+					return { fPayload(uint64_t(1) << (type - detail::MsgPackFixExt1)), false };
+				}
+				fParseError(key ? u8"Object-key which is not a string encountered" : u8"Unexpected value encountered when string was expected");
+				return {};
+			}
+			constexpr void fText(std::span<const uint8_t> bytes, auto& put) {
+				std::u8string_view view{ reinterpret_cast<const char8_t*>(bytes.data()), bytes.size() };
+				while (!view.empty()) {
+					auto [cp, len] = str::GetCodepoint<CodeError>(view);
+					if (len == 0)
+						fParseError(u8"Incomplete utf-8 encoded codepoint in str encountered");
+					view = view.substr(len);
+					if (cp != str::Invalid)
+						put(cp);
+				}
+			}
+			constexpr void fReadString(auto&& put, bool key) {
+				auto [payload, text] = fStringHead(key);
+				if (text)
+					fText(payload, put);
+				else
+					detail::Base64Url(payload, put);
+				fConsumed();
+			}
+			constexpr void fConsumed() {
+				if (!pLevels.empty())
+					--pLevels.back();
+			}
+			constexpr bool fClose() {
+				/* check if the opened container has been completed and pop it (counts as consumed value of the parent) */
+				if (pLevels.back() != 0)
+					return false;
+				pLevels.pop_back();
+				fConsumed();
+				return true;
+			}
+			constexpr void fSkipValues(uint64_t count) {
+				/* skip the values by only reading their headers and jumping over their payloads (every value
+				*	occupies at least one byte, which bounds the count for malformed sizes) */
+				while (count > 0) {
+					fEnsure(count);
+					--count;
+					uint8_t type = fPeekByte();
+					++pOffset;
+
+					if (type < detail::MsgPackFixMap || type >= detail::MsgPackNegFixInt)
+						continue;
+					if ((type & 0xf0) == detail::MsgPackFixMap)
+						count += 2 * uint64_t(type & 0x0f);
+					else if ((type & 0xf0) == detail::MsgPackFixArray)
+						count += (type & 0x0f);
+					else if ((type & 0xe0) == detail::MsgPackFixStr)
+						fPayload(type & 0x1f);
+					else if (type >= detail::MsgPackBin8 && type < detail::MsgPackExt8)
+						fPayload(fReadUInt(size_t(1) << (type - detail::MsgPackBin8)));
+					else if (type >= detail::MsgPackExt8 && type < detail::MsgPackFloat32)
+						fPayload(fReadUInt(size_t(1) << (type - detail::MsgPackExt8)) + 1);
+					else if (type == detail::MsgPackFloat32 || type == detail::MsgPackFloat64)
+						fPayload(type == detail::MsgPackFloat32 ? 4 : 8);
+					else if (type >= detail::MsgPackUInt8 && type < detail::MsgPackInt8)
+						fPayload(uint64_t(1) << (type - detail::MsgPackUInt8));
+					else if (type >= detail::MsgPackInt8 && type < detail::MsgPackFixExt1)
+						fPayload(uint64_t(1) << (type - detail::MsgPackInt8));
+					else if (type >= detail::MsgPackFixExt1 && type < detail::MsgPackStr8)
+						fPayload((uint64_t(1) << (type - detail::MsgPackFixExt1)) + 1);
+					else if (type >= detail::MsgPackStr8 && type < detail::MsgPackArray16)
+						fPayload(fReadUInt(size_t(1) << (type - detail::MsgPackStr8)));
+					else if (type >= detail::MsgPackArray16 && type < detail::MsgPackMap16)
+						count += fReadUInt(type == detail::MsgPackArray16 ? 2 : 4);
+					else if (type >= detail::MsgPackMap16)
+						count += 2 * fReadUInt(type == detail::MsgPackMap16 ? 2 : 4);
+					else if (type == detail::MsgPackNever)
+						fParseError(u8"Never-used type-byte encountered");
+				}
+			}
+
+		public:
+			constexpr bool closeElseSeparator(bool) {
+				/* messagepack does not have separators, and the container is closed once all entries have been read */
+				return fClose();
+			}
+			constexpr bool checkIsEmpty(bool) {
+				return fClose();
+			}
+			constexpr json::Type peekOrOpenNext() {
+				uint8_t type = fPeekByte();
+
+				/* check if this is starting a map or an array */
+				bool map = ((type & 0xf0) == detail::MsgPackFixMap || type == detail::MsgPackMap16 || type == detail::MsgPackMap16 + 1);
+				if (map || (type & 0xf0) == detail::MsgPackFixArray || type == detail::MsgPackArray16 || type == detail::MsgPackArray16 + 1) {
+					++pOffset;
+					uint64_t count = (type & 0x0f);
+					if (type >= detail::MsgPackArray16)
+						count = fReadUInt((type & 0x01) ? 4 : 2);
+					pLevels.push_back(map ? 2 * count : count);
+					return (map ? json::Type::object : json::Type::array);
+				}
+
+				/* check the integers, which are the fix-ints, the unsigned and the signed integers */
+				if (type < detail::MsgPackFixMap || type >= detail::MsgPackNegFixInt || (type >= detail::MsgPackUInt8 && type < detail::MsgPackFixExt1))
+					return json::Type::inumber;
+
+				/* check the remaining types */
+				if (type == detail::MsgPackNil)
+					return json::Type::null;
+				if (type == detail::MsgPackFalse || type == detail::MsgPackTrue)
+					return json::Type::boolean;
+				if (type == detail::MsgPackFloat32 || type == detail::MsgPackFloat64)
+					return json::Type::real;
+				if (type == detail::MsgPackNever)
+					fParseError(u8"Never-used type-byte encountered");
+				return json::Type::string;
+			}
+			constexpr json::Null readNull() {
+				fPeekByte();
+				++pOffset;
+				fConsumed();
+				return json::Null();
+			}
+			constexpr json::Bool readBoolean() {
+				json::Bool value = (fPeekByte() == detail::MsgPackTrue);
+				++pOffset;
+				fConsumed();
+				return value;
+			}
+			constexpr detail::NumberValue readNumber() {
+				uint8_t type = fPeekByte();
+				++pOffset;
+				fConsumed();
+
+				/* check the fix-ints and the unsigned integers */
+				if (type < detail::MsgPackFixMap)
+					return json::UNum(type);
+				if (type >= detail::MsgPackNegFixInt)
+					return json::INum(int8_t(type));
+				if (type >= detail::MsgPackUInt8 && type < detail::MsgPackInt8)
+					return json::UNum(fReadUInt(size_t(1) << (type - detail::MsgPackUInt8)));
+
+				/* sign-extend the signed integers */
+				if (type >= detail::MsgPackInt8) {
+					size_t shift = 64 - 8 * (size_t(1) << (type - detail::MsgPackInt8));
+					uint64_t value = fReadUInt(size_t(1) << (type - detail::MsgPackInt8));
+					return json::INum(int64_t(value << shift) >> shift);
+				}
+
+				/* decode the floats */
+				if (type == detail::MsgPackFloat32) {
+					uint32_t bits = uint32_t(fReadUInt(4));
+					float value = 0;
+					std::memcpy(&value, &bits, sizeof(value));
+					return json::Real(value);
+				}
+				uint64_t bits = fReadUInt(8);
+				double value = 0;
+				std::memcpy(&value, &bits, sizeof(value));
+				return json::Real(value);
+			}
+			constexpr void readString(auto& sink, bool key) {
+				fReadString([&](char32_t cp) { str::CodepointTo<CodeError>(sink, cp, 1); }, key);
+			}
+			template <class ChType>
+			constexpr bool readVerbatim(std::basic_string_view<ChType>, std::basic_string<ChType>& sink, size_t& offset, size_t& length, bool key) {
+				/* check if the string is a valid utf-8 encoded str, and return its offset/length in the source (which are the
+				*	bytes being deserialized), otherwise decode it to the sink and return its offset/length in the sink
+				*	(the source-parameter is unused, as the offsets are computed relative to the bytes of the deserializer) */
+				auto [payload, text] = fStringHead(key);
+				std::u8string_view view{ reinterpret_cast<const char8_t*>(payload.data()), payload.size() };
+				bool verbatim = text;
+				for (size_t i = 0; verbatim && i < view.size();) {
+					auto [cp, len] = str::GetCodepoint<str::err::Skip>(view.substr(i));
+					verbatim = (len > 0 && cp != str::Invalid);
+					i += len;
+				}
+
+				if (verbatim) {
+					offset = size_t(payload.data() - pBytes.data());
+					length = payload.size();
+				}
+				else {
+					offset = sink.size();
+					auto put = [&](char32_t cp) { str::CodepointTo<CodeError>(sink, cp, 1); };
+					if (text)
+						fText(payload, put);
+					else
+						detail::Base64Url(payload, put);
+					length = sink.size() - offset;
+				}
+				fConsumed();
+				return verbatim;
+			}
+			constexpr void matchString(detail::KeyMatcher& matcher, bool key) {
+				/* feed the decoded codepoints directly to the matcher without materializing the string */
+				fReadString([&](char32_t cp) { matcher.next(cp); }, key);
+			}
+			constexpr void skipValue() {
+				fSkipValues(1);
+				fConsumed();
+			}
+			constexpr void skipContainer(bool) {
+				/* skip the remaining values of the opened map/array without decoding them */
+				uint64_t remaining = pLevels.back();
+				pLevels.pop_back();
+				fSkipValues(remaining);
+				fConsumed();
+			}
+			constexpr bool interrupted() const {
+				return false;
+			}
+			constexpr json::Bookmark tokenBookmark() const {
+				return json::Bookmark{ pOrigin + pTokenOffset, pOrigin + pTokenOffset };
+			}
+			constexpr void setOrigin(const json::Bookmark& bookmark) {
+				pOrigin = bookmark.offset;
+			}
+			constexpr void checkDone() {
+				if (pOffset != pBytes.size())
+					throw json::DeserializeException(L"Unexpected trailing bytes encountered at byte ", pOrigin + pOffset);
+			}
+		};
+
+		template <class SinkType, char32_t CodeError>
+			requires json::IsMsgPackSink<SinkType>
+		class Serializer<SinkType, CodeError> {
+		private:
+			/* index of the header of the opened container, which is filled once its size is known */
+			struct Open {
+				size_t header = 0;
+				uint64_t count = 0;
+				bool object = false;
+			};
+
+			/* header of a container and the offset within the buffer, in front of which it is written out (the headers
+			*	are allocated in the order the containers are opened, and are therefore ordered by their offsets) */
+			struct Header {
+				size_t offset = 0;
+				uint8_t bytes[5] = { 0 };
+				uint8_t size = 0;
+			};
+
+		private:
+			std::remove_cvref_t<SinkType> pSink;
+			std::vector<uint8_t> pBuffer;
+			std::vector<Header> pHeaders;
+			std::vector<Open> pOpen;
+			std::string pText;
+
+		private:
+			constexpr void fWrite(const uint8_t* data, size_t size) {
+				if (pOpen.empty())
+					pSink.write(data, size);
+				else
+					pBuffer.insert(pBuffer.end(), data, data + size);
+			}
+			static constexpr size_t fHead(uint8_t* buf, uint8_t type, uint64_t value, size_t size) {
+				/* write the type and the big-endian value */
+				buf[0] = type;
+				for (size_t i = 0; i < size; ++i)
+					buf[1 + i] = uint8_t(value >> (8 * (size - 1 - i)));
+				return 1 + size;
+			}
+			static constexpr size_t fSized(uint8_t* buf, uint8_t type16, uint64_t value) {
+				/* write the 16-bit or 32-bit header of the str/array/map (32-bit variants follow the 16-bit variants) */
+				if (value <= 0xffff)
+					return fHead(buf, type16, value, 2);
+				if (value > 0xffffffff)
+					throw json::RangeException(L"Messagepack strings, arrays and objects are limited to 2^32-1 entries");
+				return fHead(buf, type16 + 1, value, 4);
+			}
+			constexpr void fString(const auto& s) {
+				pText.clear();
+				str::TranscodeAllTo<CodeError>(pText, s);
+
+				uint8_t buf[9] = { 0 };
+				size_t size = 0;
+				if (pText.size() < 32)
+					size = fHead(buf, uint8_t(detail::MsgPackFixStr | pText.size()), 0, 0);
+				else if (pText.size() <= 0xff)
+					size = fHead(buf, detail::MsgPackStr8, pText.size(), 1);
+				else
+					size = fSized(buf, detail::MsgPackStr8 + 1, pText.size());
+				fWrite(buf, size);
+				fWrite(reinterpret_cast<const uint8_t*>(pText.data()), pText.size());
+			}
+			constexpr void fInt(int64_t value) {
+				/* write the integer in the shortest signed form */
+				uint8_t buf[9] = { 0 };
+				size_t size = 0;
+				if (value >= -32)
+					size = fHead(buf, uint8_t(value), 0, 0);
+				else if (value >= std::numeric_limits<int8_t>::min())
+					size = fHead(buf, detail::MsgPackInt8, uint64_t(value), 1);
+				else if (value >= std::numeric_limits<int16_t>::min())
+					size = fHead(buf, detail::MsgPackInt8 + 1, uint64_t(value), 2);
+				else if (value >= std::numeric_limits<int32_t>::min())
+					size = fHead(buf, detail::MsgPackInt8 + 2, uint64_t(value), 4);
+				else
+					size = fHead(buf, detail::MsgPackInt8 + 3, uint64_t(value), 8);
+				fWrite(buf, size);
+			}
+			constexpr void fUInt(uint64_t value) {
+				/* write the integer in the shortest unsigned form */
+				uint8_t buf[9] = { 0 };
+				size_t size = 0;
+				if (value < detail::MsgPackFixMap)
+					size = fHead(buf, uint8_t(value), 0, 0);
+				else if (value <= 0xff)
+					size = fHead(buf, detail::MsgPackUInt8, value, 1);
+				else if (value <= 0xffff)
+					size = fHead(buf, detail::MsgPackUInt8 + 1, value, 2);
+				else if (value <= 0xffffffff)
+					size = fHead(buf, detail::MsgPackUInt8 + 2, value, 4);
+				else
+					size = fHead(buf, detail::MsgPackUInt8 + 3, value, 8);
+				fWrite(buf, size);
+			}
+			constexpr void fFloat(double value) {
+				/* write the real as float32, if it can be represented exactly */
+				uint8_t buf[9] = { 0 };
+				size_t size = 0;
+				if (float(value) == value || std::isnan(value)) {
+					float single = float(value);
+					uint32_t bits = 0;
+					std::memcpy(&bits, &single, sizeof(bits));
+					size = fHead(buf, detail::MsgPackFloat32, bits, 4);
+				}
+				else {
+					uint64_t bits = 0;
+					std::memcpy(&bits, &value, sizeof(bits));
+					size = fHead(buf, detail::MsgPackFloat64, bits, 8);
+				}
+				fWrite(buf, size);
+			}
+
+		public:
+			constexpr Serializer(const auto& sink, const std::wstring_view&) : pSink{ sink } {}
+
+		public:
+			constexpr std::remove_cvref_t<SinkType>& sink() {
+				return pSink;
+			}
+			constexpr void primitive(const auto& v) {
+				using VType = std::remove_cvref_t<decltype(v)>;
+
+				if constexpr (std::same_as<VType, json::Bool>) {
+					uint8_t type = (v ? detail::MsgPackTrue : detail::MsgPackFalse);
+					fWrite(&type, 1);
+				}
+				else if constexpr (std::same_as<VType, json::Null>) {
+					uint8_t type = detail::MsgPackNil;
+					fWrite(&type, 1);
+				}
+				else if constexpr (std::floating_point<VType>)
+					fFloat(double(v));
+				else if constexpr (std::integral<VType>) {
+					if constexpr (std::is_signed_v<VType>) {
+						if (v < 0) {
+							fInt(int64_t(v));
+							return;
+						}
+					}
+					fUInt(uint64_t(v));
+				}
+				else
+					fString(v);
+			}
+			constexpr void begin(bool obj) {
+				pOpen.push_back(Open{ pHeaders.size(), 0, obj });
+				pHeaders.push_back(Header{ pBuffer.size() });
+			}
+			constexpr void objectKey(const auto& s) {
+				++pOpen.back().count;
+				fString(s);
+			}
+			constexpr void arrayValue() {
+				++pOpen.back().count;
+			}
+			constexpr void arrayValues(const auto& values) {
+				pOpen.back().count += std::size(values);
+				for (const auto& value : values)
+					primitive(value);
+			}
+			constexpr void end(bool) {
+				Open open = pOpen.back();
+				pOpen.pop_back();
+
+				/* write the header of the container, which is placed in front of its values */
+				Header& header = pHeaders[open.header];
+				if (open.count < 16)
+					header.size = uint8_t(fHead(header.bytes, uint8_t((open.object ? detail::MsgPackFixMap : detail::MsgPackFixArray) | open.count), 0, 0));
+				else
+					header.size = uint8_t(fSized(header.bytes, open.object ? detail::MsgPackMap16 : detail::MsgPackArray16, open.count));
+
+				/* write the headers and values out interleaved, once the outermost container has been completed
+				*	(instead of inserting each header into the buffer, which would move all values once per nesting level) */
+				if (pOpen.empty()) {
+					size_t offset = 0;
+					for (const Header& next : pHeaders) {
+						pSink.write(pBuffer.data() + offset, next.offset - offset);
+						pSink.write(next.bytes, next.size);
+						offset = next.offset;
+					}
+					pSink.write(pBuffer.data() + offset, pBuffer.size() - offset);
+					pBuffer.clear();
+					pHeaders.clear();
+				}
+			}
+		};
+	}
+}
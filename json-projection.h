@@ -0,0 +1,243 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include "json-common.h"
+#include "json-deserializer.h"
+#include "json-cbor.h"
+#include "json-msgpack.h"
+#include "json-deserialize.h"
+#include "json-value.h"
+
+namespace json {
+	namespace detail {
+		template <class StreamType, char32_t CodeError>
+		class JsonProjector;
+	}
+
+	/* set of json-pointers (RFC 6901), which are to be extracted from a json-stream, and which are assigned
+	*	the ids in the order of insertion (tokens, which are valid array-indices, match object-keys and array-indices) */
+	class Projection {
+		template <class StreamType, char32_t CodeError>
+		friend class detail::JsonProjector;
+	private:
+		struct Node {
+			std::vector<std::pair<json::Str, size_t>> keys;
+			std::vector<std::pair<size_t, size_t>> indices;
+			std::vector<size_t> outputs;
+		};
+
+	private:
+		std::vector<Node> pNodes;
+		size_t pCount = 0;
+
+	public:
+		Projection() : pNodes(1) {}
+		Projection(std::initializer_list<json::StrView> pointers) : pNodes(1) {
+			for (const json::StrView& pointer : pointers)
+				add(pointer);
+		}
+
+	private:
+		size_t fChild(size_t node, const json::Str& token) {
+			/* check if the child already exists (keys are kept sorted for the key-matcher) */
+			auto it = std::lower_bound(pNodes[node].keys.begin(), pNodes[node].keys.end(), token, [](const auto& entry, const json::Str& key) { return entry.first < key; });
+			if (it != pNodes[node].keys.end() && it->first == token)
+				return it->second;
+			size_t child = pNodes.size();
+			pNodes[node].keys.insert(it, { token, child });
+
+			/* check if the token is a valid array-index (no leading zeros) and register it as index as well */
+			if (!token.empty() && token.size() <= std::numeric_limits<size_t>::digits10 && (token.size() == 1 || token[0] != L'0')) {
+				size_t index = 0;
+				for (wchar_t c : token) {
+					if (c < L'0' || c > L'9') {
+						index = size_t(-1);
+						break;
+					}
+					index = index * 10 + size_t(c - L'0');
+				}
+				if (index != size_t(-1)) {
+					auto at = std::lower_bound(pNodes[node].indices.begin(), pNodes[node].indices.end(), index, [](const auto& entry, size_t i) { return entry.first < i; });
+					pNodes[node].indices.insert(at, { index, child });
+				}
+			}
+
+			/* allocate the new node (invalidates any references to the nodes) */
+			pNodes.emplace_back();
+			return child;
+		}
+
+	public:
+		/* add the json-pointer to the projection and return its id (the empty pointer references the entire value) */
+		size_t add(json::StrView pointer) {
+			if (!pointer.empty() && pointer[0] != L'/')
+				throw json::ProjectionException(L"Json-pointer must be empty or start with [/]");
+
+			/* walk the tokens of the pointer and unescape [~0] and [~1] */
+			size_t node = 0;
+			while (!pointer.empty()) {
+				pointer = pointer.substr(1);
+				json::Str token;
+				while (!pointer.empty() && pointer[0] != L'/') {
+					if (pointer[0] != L'~')
+						token.push_back(pointer[0]);
+					else if (pointer.size() > 1 && (pointer[1] == L'0' || pointer[1] == L'1')) {
+						token.push_back(pointer[1] == L'0' ? L'~' : L'/');
+						pointer = pointer.substr(1);
+					}
+					else
+						throw json::ProjectionException(L"Malformed [~] escape-sequence in json-pointer");
+					pointer = pointer.substr(1);
+				}
+				node = fChild(node, token);
+			}
+
+			pNodes[node].outputs.push_back(pCount);
+			return pCount++;
+		}
+
+		/* number of json-pointers in the projection */
+		size_t size() const {
+			return pCount;
+		}
+	};
+
+	namespace detail {
+		template <class StreamType, char32_t CodeError>
+		class JsonProjector {
+		private:
+			detail::Deserializer<StreamType, CodeError>& pDeserializer;
+			const json::Projection& pProjection;
+			std::vector<std::vector<detail::KeyEntry>> pEntries;
+			std::vector<json::Value>& pOut;
+
+		private:
+			constexpr void fResolve(const json::Value& value, size_t node) {
+				const json::Projection::Node& self = pProjection.pNodes[node];
+				for (size_t output : self.outputs)
+					pOut[output] = value;
+
+				/* resolve all nested json-pointers from the already materialized value */
+				if (value.isObj()) {
+					for (const auto& [key, child] : self.keys) {
+						if (value.contains(key))
+							fResolve(value[key], child);
+					}
+				}
+				else if (value.isArr()) {
+					for (const auto& [index, child] : self.indices) {
+						if (value.has(index))
+							fResolve(value[index], child);
+					}
+				}
+			}
+			constexpr void fReset(size_t node) {
+				const json::Projection::Node& self = pProjection.pNodes[node];
+				for (size_t output : self.outputs)
+					pOut[output] = json::Null();
+
+				/* reset all nested json-pointers (indices reference the same children as their keys) */
+				for (const auto& [key, child] : self.keys)
+					fReset(child);
+			}
+			constexpr void fObject(size_t node) {
+				if (pDeserializer.checkIsEmpty(true))
+					return;
+
+				/* match the keys without materializing them and skip the values of all unknown keys (for multiple identical
+				*	keys, the last occurring value will be used, for which the values of the earlier occurrences are reset) */
+				do {
+					detail::KeyMatcher matcher{ pEntries[node] };
+					pDeserializer.matchString(matcher, true);
+					if (size_t child = matcher.id(); child != json::UnknownKey) {
+						fReset(child);
+						fValue(child);
+					}
+					else
+						pDeserializer.skipValue();
+				} while (!pDeserializer.closeElseSeparator(true));
+			}
+			constexpr void fArray(size_t node) {
+				const json::Projection::Node& self = pProjection.pNodes[node];
+				if (pDeserializer.checkIsEmpty(false))
+					return;
+
+				/* read the projected indices and skip the remainder of the array once all indices have been visited */
+				size_t index = 0, next = 0;
+				do {
+					if (next >= self.indices.size()) {
+						pDeserializer.skipContainer(false);
+						return;
+					}
+					if (self.indices[next].first == index)
+						fValue(self.indices[next++].second);
+					else
+						pDeserializer.skipValue();
+					++index;
+				} while (!pDeserializer.closeElseSeparator(false));
+			}
+			constexpr void fValue(size_t node) {
+				const json::Projection::Node& self = pProjection.pNodes[node];
+
+				/* check if the value itself is projected, in which case it is materialized entirely */
+				if (!self.outputs.empty()) {
+					json::Value value;
+					detail::JsonDeserializer<StreamType, CodeError>{ pDeserializer }.read(value);
+					fResolve(value, node);
+					return;
+				}
+
+				/* check if the value cannot contain any projected values and skip it without materializing it */
+				switch (pDeserializer.peekOrOpenNext()) {
+				case json::Type::object:
+					if (self.keys.empty())
+						pDeserializer.skipContainer(true);
+					else
+						fObject(node);
+					break;
+				case json::Type::array:
+					if (self.indices.empty())
+						pDeserializer.skipContainer(false);
+					else
+						fArray(node);
+					break;
+				default:
+					pDeserializer.skipValue();
+					break;
+				}
+			}
+
+		public:
+			constexpr JsonProjector(detail::Deserializer<StreamType, CodeError>& deserializer, const json::Projection& projection, std::vector<json::Value>& out) : pDeserializer{ deserializer }, pProjection{ projection }, pOut{ out } {
+				/* setup the sorted key-entries of all nodes for the key-matcher */
+				pEntries.resize(pProjection.pNodes.size());
+				for (size_t i = 0; i < pEntries.size(); ++i) {
+					for (const auto& [key, child] : pProjection.pNodes[i].keys)
+						pEntries[i].push_back(detail::KeyEntry{ key, child });
+				}
+			}
+
+		public:
+			constexpr void read() {
+				fValue(0);
+			}
+		};
+	}
+
+	/* deserialize only the values referenced by the json-pointers of the projection from the stream, and return
+	*	them indexed by their id (missing values are null), while all other values are skipped without being decoded
+	*	- interprets \u escape-sequences as utf-16 encoding
+	*	- expects entire stream to be a single json value until the end with optional whitespace padding
+	*	- for objects with multiple identical keys, the last occurring value will be used */
+	template <char32_t CodeError = str::err::DefChar>
+	constexpr std::vector<json::Value> Project(json::IsInput auto&& stream, const json::Projection& projection) {
+		using StreamType = decltype(stream);
+
+		detail::Deserializer<std::remove_reference_t<StreamType>, CodeError> deserializer{ std::forward<StreamType>(stream) };
+		std::vector<json::Value> out(projection.size());
+		detail::JsonProjector<std::remove_reference_t<StreamType>, CodeError>{ deserializer, projection, out }.read();
+		deserializer.checkDone();
+		return out;
+	}
+}
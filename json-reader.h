@@ -4,7 +4,10 @@
 
 #include "json-common.h"
 #include "json-deserializer.h"
+#include "json-cbor.h"
+#include "json-msgpack.h"
 #include "json-value.h"
+#include "json-viewer.h"
 
 namespace json {
 	namespace detail {
@@ -13,7 +16,14 @@ namespace json {
 
 	/* check if the given type is a valid reader-stream */
 	template <class Type>
-	concept IsReadType = str::IsStream<Type> || std::is_same_v<Type, detail::ReadAnyType>;
+	concept IsReadType = json::IsInput<Type> || std::is_same_v<Type, detail::ReadAnyType> || std::is_same_v<Type, json::Feed>;
+
+	/* result of advancing a reader (needsInput is only returned for readers of a json::Feed, which has been exhausted) */
+	enum class ReadStatus : uint8_t {
+		value,
+		end,
+		needsInput
+	};
 
 	template <json::IsReadType StreamType, char32_t CodeError = str::err::DefChar>
 	class Reader;
@@ -26,178 +36,369 @@ namespace json {
 		template <class StreamType, char32_t CodeError>
 		class ReaderState;
 
-		using StrReader = std::shared_ptr<json::Str>;
+		/* string is only valid until the owning reader advances to the next value */
+		template <class StreamType, char32_t CodeError>
+		struct StrReference {
+			std::shared_ptr<detail::ReaderState<StreamType, CodeError>> state;
+			json::StrView value;
+		};
 
 		template <class StreamType, char32_t CodeError>
 		struct ArrReference {
 			std::shared_ptr<detail::ReaderState<StreamType, CodeError>> state;
 			size_t stamp = 0;
+			json::Bookmark bookmark;
 		};
 
 		template <class StreamType, char32_t CodeError>
 		struct ObjReference {
 			std::shared_ptr<detail::ReaderState<StreamType, CodeError>> state;
 			size_t stamp = 0;
+			json::Bookmark bookmark;
 		};
 
 		/* json-null first to default-construct as null */
 		template <class StreamType, char32_t CodeError>
-		using ReaderParent = std::variant<json::Null, json::UNum, json::INum, json::Real, json::Bool, detail::StrReader, detail::ArrReference<StreamType, CodeError>, detail::ObjReference<StreamType, CodeError>>;
+		using ReaderParent = std::variant<json::Null, json::UNum, json::INum, json::Real, json::Bool, detail::StrReference<StreamType, CodeError>, detail::ArrReference<StreamType, CodeError>, detail::ObjReference<StreamType, CodeError>>;
+
+		/* values as stored by the state itself (cannot reference the state, as this would otherwise result in reference-cycles) */
+		struct ReaderString {};
+		struct ReaderContainer {
+			size_t stamp = 0;
+			bool object = false;
+			json::Bookmark bookmark;
+		};
+		using ReaderEntry = std::variant<json::Null, json::UNum, json::INum, json::Real, json::Bool, detail::ReaderString, detail::ReaderContainer>;
 
 		template <class StreamType, char32_t CodeError>
 		class ReaderState {
-		public:
+		private:
+			/* progress of reading the next entry of the top-most instance (allows an entry, which has been
+			*	interrupted by an exhausted json::Feed, to be continued where the deserializer stopped) */
+			enum class Phase : uint8_t {
+				entry,
+				key,
+				value,
+				skip,
+				closing
+			};
 			struct Instance {
-				/* explicit construction necessary, as default-constructor is private and cannot be accessed by std::pair */
-				std::pair<json::Str, json::Reader<StreamType, CodeError>> value = { L"", {} };
-				std::unique_ptr<Instance> self;
+				detail::ReaderEntry value;
+				json::Str key;
+				json::Str string;
+				size_t stamp = 0;
 				bool object = false;
 				bool opened = false;
+				bool claimed = false;
 			};
 
 		private:
-			using ActStream = std::conditional_t<std::is_same_v<StreamType, detail::ReadAnyType>, std::unique_ptr<str::InheritStream>, StreamType>;
+			static constexpr bool IsFeed = std::is_same_v<StreamType, json::Feed>;
+			using ActStream = std::conditional_t<std::is_same_v<StreamType, detail::ReadAnyType>, std::unique_ptr<detail::BlockSource>, std::conditional_t<IsFeed, json::Feed&, StreamType>>;
 
 		private:
 			detail::Deserializer<ActStream, CodeError> pDeserializer;
-			std::vector<Instance*> pActive;
+			std::vector<std::unique_ptr<Instance>> pStack;
+			json::Str pString;
+			detail::KeyMatcher pMatcher{ {} };
+			size_t pDepth = 0;
 			size_t pNextStamp = 0;
+			Phase pPhase = Phase::entry;
+			bool pPartial = false;
 
 		public:
 			template <class Type>
 			constexpr ReaderState(Type&& stream) : pDeserializer{ std::forward<Type>(stream) } {}
+			template <class Type>
+			constexpr ReaderState(Type&& stream, const json::Bookmark& origin) : pDeserializer{ std::forward<Type>(stream) }, pPartial{ true } {
+				pDeserializer.setOrigin(origin);
+			}
 			constexpr ~ReaderState() {
-				/* close all opened objects (will ensure the entire json is parsed properly) */
-				while (!pActive.empty())
-					while (fReadNextValue(nullptr)) {}
+				/* close all opened objects (will ensure the entire json is well-formed, unless a json::Feed is exhausted) */
+				try {
+					while (pDepth > 0)
+						fSkipTop();
+				}
+				catch (const detail::NeedsInput&) {}
 			}
 
 		private:
-			constexpr json::Reader<StreamType, CodeError> fValue(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& _this) {
+			constexpr size_t fPush(bool object) {
+				/* the instances above the current depth are kept as released instances and are reused
+				*	(instances are only allocated once the maximum depth so far is exceeded) */
+				if (pDepth == pStack.size())
+					pStack.push_back(std::make_unique<Instance>());
+				Instance* inst = pStack[pDepth++].get();
+
+				/* setup the instance as new active instance */
+				inst->value = json::Null();
+				inst->stamp = ++pNextStamp;
+				inst->object = object;
+				inst->opened = false;
+				inst->claimed = false;
+				return pNextStamp;
+			}
+			constexpr void fPop() {
+				/* check if the end has been reached and a valid json-end has been found (values read from a bookmark are only a part of
+				*	the stream, and can therefore be followed by anything), before releasing the instance, to be continued if interrupted */
+				if (pDepth == 1 && !pPartial)
+					pDeserializer.checkDone();
+
+				/* release the instance and mark the active-state as changed */
+				--pDepth;
+				++pNextStamp;
+				pPhase = Phase::entry;
+			}
+			constexpr void fSkipTop() {
+				if (pPhase != Phase::closing) {
+					/* complete the interrupted skip of a value of an unknown key first (interrupted tokens are skipped as part of the container) */
+					if (pPhase == Phase::skip)
+						pDeserializer.skipValue();
+					pPhase = Phase::entry;
+
+					/* skip all remaining values of the top-most instance without materializing them (all
+					*	previously read values have been consumed entirely, as opened values are on the stack) */
+					pDeserializer.skipContainer(pStack[pDepth - 1]->object);
+					pPhase = Phase::closing;
+				}
+				fPop();
+			}
+			constexpr bool fActive(size_t depth, size_t stamp) const {
+				/* check if the instance is still in the active stack (stamp ensures released or reused instances are not matched) */
+				return (depth < pDepth && pStack[depth]->stamp == stamp);
+			}
+			constexpr detail::ReaderEntry fValue(json::Str& string) {
 				switch (pDeserializer.peekOrOpenNext()) {
 				case json::Type::unumber:
 				case json::Type::inumber:
 				case json::Type::real: {
 					detail::NumberValue num = pDeserializer.readNumber();
 					if (std::holds_alternative<json::INum>(num))
-						return json::Reader<StreamType, CodeError>{ detail::ReaderParent<StreamType, CodeError>{ std::get<json::INum>(num) } };
+						return std::get<json::INum>(num);
 					if (std::holds_alternative<json::UNum>(num))
-						return json::Reader<StreamType, CodeError>{ detail::ReaderParent<StreamType, CodeError>{ std::get<json::UNum>(num) } };
-					return json::Reader<StreamType, CodeError>{ detail::ReaderParent<StreamType, CodeError>{ std::get<json::Real>(num) } };
+						return std::get<json::UNum>(num);
+					return std::get<json::Real>(num);
 				}
 				case json::Type::boolean:
-					return json::Reader<StreamType, CodeError>{ detail::ReaderParent<StreamType, CodeError>{ pDeserializer.readBoolean() } };
-				case json::Type::string: {
-					detail::StrReader str = std::make_shared<json::Str>();
-					pDeserializer.readString(*str, false);
-					return json::Reader<StreamType, CodeError>{ detail::ReaderParent<StreamType, CodeError>{ str } };
-				}
+					return pDeserializer.readBoolean();
+				case json::Type::string:
+					pDeserializer.readString(string, false);
+					return detail::ReaderString{};
 				case json::Type::array: {
-					std::unique_ptr<Instance> inst = std::make_unique<Instance>();
-					pActive.push_back(inst.get());
-					inst->object = false;
-					inst->self = std::move(inst);
-					return json::Reader<StreamType, CodeError>{ detail::ReaderParent<StreamType, CodeError>{ detail::ArrReference<StreamType, CodeError>{ _this, ++pNextStamp } } };
+					json::Bookmark bookmark = pDeserializer.tokenBookmark();
+					return detail::ReaderContainer{ fPush(false), false, bookmark };
 				}
 				case json::Type::object: {
-					std::unique_ptr<Instance> inst = std::make_unique<Instance>();
-					pActive.push_back(inst.get());
-					inst->object = true;
-					inst->self = std::move(inst);
-					return json::Reader<StreamType, CodeError>{ detail::ReaderParent<StreamType, CodeError>{ detail::ObjReference<StreamType, CodeError>{ _this, ++pNextStamp } } };
+					json::Bookmark bookmark = pDeserializer.tokenBookmark();
+					return detail::ReaderContainer{ fPush(true), true, bookmark };
 				}
 				case json::Type::null:
 				default:
-					return json::Reader<StreamType, CodeError>{ detail::ReaderParent<StreamType, CodeError>{ pDeserializer.readNull() } };
+					return pDeserializer.readNull();
 				}
 			}
-			constexpr bool fReadNextValue(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& _this) {
-				/* cache the instance-pointer as reading the next value might push to the active-stack */
-				Instance* inst = pActive.back();
-
-				/* check if this is the first value being read, in which case no separator is required,
-				*	or if no value is found anymore, in which case the instance can be released */
-				if (inst->opened ? pDeserializer.closeElseSeparator(inst->object) : pDeserializer.checkIsEmpty(inst->object)) {
-					inst->self.reset();
-					pActive.pop_back();
-
-					/* mark the active-state as changed and check if the end has been reached and a valid json-end has been found */
-					++pNextStamp;
-					if (pActive.empty())
-						pDeserializer.checkDone();
+			constexpr bool fOpenNextEntry(Instance* inst) {
+				/* check if this is the first value being read, in which case no separator is required, or if no value
+				*	is found anymore, in which case the instance can be released (unless the closing has been interrupted) */
+				if (pPhase == Phase::closing || (inst->opened ? pDeserializer.closeElseSeparator(inst->object) : pDeserializer.checkIsEmpty(inst->object))) {
+					pPhase = Phase::closing;
+					fPop();
 					return false;
 				}
 
 				/* mark the next value as not being the first anymore */
 				inst->opened = true;
+				return true;
+			}
+			constexpr bool fReadNextValue() {
+				/* cache the instance-pointer as reading the next value might push to the active-stack */
+				Instance* inst = pStack[pDepth - 1].get();
+
+				/* open the next entry, unless an interrupted entry is being continued */
+				if (pPhase == Phase::entry || pPhase == Phase::closing) {
+					if (!fOpenNextEntry(inst))
+						return false;
+					inst->key.clear();
+					inst->string.clear();
+					pPhase = (inst->object ? Phase::key : Phase::value);
+				}
 
 				/* check if a key needs to be read */
-				if (inst->object) {
-					inst->value.first.clear();
-					pDeserializer.readString(inst->value.first, true);
+				if (pPhase == Phase::key) {
+					pDeserializer.readString(inst->key, true);
+					pPhase = Phase::value;
 				}
 
 				/* read the next value */
-				inst->value.second = fValue(_this);
+				inst->value = fValue(inst->string);
+				pPhase = Phase::entry;
 				return true;
 			}
+			constexpr json::Reader<StreamType, CodeError> fMake(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& _this, const detail::ReaderEntry& entry, const json::Str& string) const {
+				using Parent = detail::ReaderParent<StreamType, CodeError>;
+
+				if (std::holds_alternative<detail::ReaderString>(entry))
+					return json::Reader<StreamType, CodeError>{ Parent{ detail::StrReference<StreamType, CodeError>{ _this, string } } };
+				if (std::holds_alternative<detail::ReaderContainer>(entry)) {
+					const detail::ReaderContainer& container = std::get<detail::ReaderContainer>(entry);
+					if (container.object)
+						return json::Reader<StreamType, CodeError>{ Parent{ detail::ObjReference<StreamType, CodeError>{ _this, container.stamp, container.bookmark } } };
+					return json::Reader<StreamType, CodeError>{ Parent{ detail::ArrReference<StreamType, CodeError>{ _this, container.stamp, container.bookmark } } };
+				}
+				if (std::holds_alternative<json::INum>(entry))
+					return json::Reader<StreamType, CodeError>{ Parent{ std::get<json::INum>(entry) } };
+				if (std::holds_alternative<json::UNum>(entry))
+					return json::Reader<StreamType, CodeError>{ Parent{ std::get<json::UNum>(entry) } };
+				if (std::holds_alternative<json::Real>(entry))
+					return json::Reader<StreamType, CodeError>{ Parent{ std::get<json::Real>(entry) } };
+				if (std::holds_alternative<json::Bool>(entry))
+					return json::Reader<StreamType, CodeError>{ Parent{ std::get<json::Bool>(entry) } };
+				return json::Reader<StreamType, CodeError>{ Parent{ json::Null() } };
+			}
 
-		public:
-			constexpr bool next(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& _this, Instance* instance) {
+			template <class Fn>
+			constexpr auto fRestartable(Fn fn) {
+				if constexpr (!IsFeed)
+					return fn();
+				else {
+					/* checkpoint the state to roll back to, in case the json::Feed is exhausted before the value, which
+					*	cannot be continued, has been read entirely (the value is read again once more input has been fed) */
+					detail::FeedCheckpoint checkpoint = pDeserializer.checkpoint();
+					size_t depth = pDepth, stamp = pNextStamp;
+					bool opened = (depth > 0 && pStack[depth - 1]->opened);
+					try {
+						return fn();
+					}
+					catch (const detail::NeedsInput&) {
+						pDeserializer.rollback(checkpoint);
+						pDepth = depth;
+						pNextStamp = stamp;
+						if (depth > 0)
+							pStack[depth - 1]->opened = opened;
+						throw;
+					}
+				}
+			}
+			constexpr void fAdvance(size_t depth, size_t stamp) {
 				/* check if the instance is still in the active stack */
-				size_t index = pActive.size();
-				while (index > 0 && pActive[index - 1] != instance)
-					--index;
-				if (index == 0)
+				if (!fActive(depth, stamp))
 					throw json::ReaderException(L"Reader is not in an active state");
 
-				/* close all other open objects until the current object has been reached */
-				while (pActive.size() > index) {
-					while (fReadNextValue(_this)) {}
-				}
+				/* skip all other open objects until the current object has been reached (an interrupted skip
+				*	is continued by the next advance once more input has been fed) */
+				while (pDepth > depth + 1)
+					fSkipTop();
+			}
 
-				/* check if another value is encountered and read it */
-				return fReadNextValue(_this);
+		public:
+			constexpr bool next(size_t depth, size_t stamp) {
+				fAdvance(depth, stamp);
+
+				/* check if another value is encountered and read it (an interrupted entry
+				*	is continued by the next advance once more input has been fed) */
+				return fReadNextValue();
+			}
+			constexpr const detail::KeyEntry* nextOf(size_t depth, size_t stamp, std::span<const detail::KeyEntry> keys) {
+				fAdvance(depth, stamp);
+				Instance* instance = pStack[depth].get();
+
+				/* match the keys directly while decoding them and skip all values of unknown keys (the
+				*	matcher is kept in the state, to continue an interrupted entry once more input has been fed) */
+				while (true) {
+					if (pPhase == Phase::entry || pPhase == Phase::closing) {
+						if (!fOpenNextEntry(instance))
+							return nullptr;
+						instance->string.clear();
+						pMatcher = detail::KeyMatcher{ keys };
+						pPhase = Phase::key;
+					}
+					if (pPhase == Phase::key) {
+						pDeserializer.matchString(pMatcher, true);
+						pPhase = (pMatcher.id() == json::UnknownKey ? Phase::skip : Phase::value);
+					}
+					if (pPhase == Phase::skip) {
+						pDeserializer.skipValue();
+						pPhase = Phase::entry;
+						continue;
+					}
+
+					/* read the value of the known key */
+					instance->value = fValue(instance->string);
+					pPhase = Phase::entry;
+					return &pMatcher.entry();
+				}
 			}
 			constexpr json::Reader<StreamType, CodeError> initValue(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& _this) {
-				json::Reader<StreamType, CodeError> value = fValue(_this);
+				detail::ReaderEntry entry = fRestartable([&]() {
+					pString.clear();
+					detail::ReaderEntry entry = fValue(pString);
 
-				/* check if this is not an opened value and should therefore have consumed the entire source */
-				if (pActive.empty())
-					pDeserializer.checkDone();
-				return value;
+					/* check if this is not an opened value and should therefore have consumed the entire source */
+					if (pDepth == 0 && !pPartial)
+						pDeserializer.checkDone();
+					return entry;
+				});
+				return fMake(_this, entry, pString);
+			}
+			constexpr json::Reader<StreamType, CodeError> current(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& _this, size_t depth) const {
+				return fMake(_this, pStack[depth]->value, pStack[depth]->string);
+			}
+			constexpr json::StrView key(size_t depth) const {
+				return pStack[depth]->key;
 			}
-			constexpr std::unique_ptr<Instance> open(size_t stamp, bool object) {
-				/* check if the object is the next in line and has not yet been fetched */
-				if (stamp != pNextStamp || pActive.back()->self.get() == 0)
+			constexpr size_t open(size_t stamp, bool object) {
+				/* check if the object is the next in line and has not yet been fetched or skipped */
+				if (stamp != pNextStamp || pStack[pDepth - 1]->claimed || pDeserializer.interrupted())
 					throw json::ReaderException(object ? L"Object has already been opened for reading" : L"Array has already been opened for reading");
 
-				/* fetch the instance-pointer */
-				std::unique_ptr<Instance> inst;
-				pActive.back()->self.swap(inst);
-				return std::move(inst);
+				/* mark the instance as claimed by the corresponding reader and return its depth */
+				pStack[pDepth - 1]->claimed = true;
+				return pDepth - 1;
 			}
-			constexpr void close(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& _this, Instance* instance) {
+			constexpr json::Viewer view(size_t stamp, bool object) {
+				/* check if the object is the next in line and has not yet been fetched or skipped */
+				if (stamp != pNextStamp || pStack[pDepth - 1]->claimed || pDeserializer.interrupted())
+					throw json::ReaderException(object ? L"Object has already been opened for reading" : L"Array has already been opened for reading");
+
+				/* parse the remainder of the object directly into the view and release the instance */
+				std::shared_ptr<detail::ViewState> state = std::make_shared<detail::ViewState>();
+				detail::ViewWord root = 0;
+				try {
+					fRestartable([&]() {
+						root = detail::ViewDeserializer<ActStream, CodeError>{ pDeserializer }.readOpened(*state.get(), object);
+						fPop();
+					});
+				}
+				catch (const detail::NeedsInput&) {
+					throw json::ReaderException(L"Reader requires more input to be fed");
+				}
+				state->sync();
+				return detail::ViewAccess::Make(state, root);
+			}
+			constexpr void close(size_t depth, size_t stamp) {
 				/* check if the instance is still in the active stack */
-				size_t index = pActive.size();
-				while (index > 0 && pActive[index - 1] != instance)
-					--index;
-				if (index == 0)
+				if (!fActive(depth, stamp))
 					return;
 
-				/* close all other open objects including this object */
-				while (pActive.size() >= index) {
-					while (fReadNextValue(_this)) {}
+				/* skip all other open objects including this object (skips interrupted by an exhausted
+				*	json::Feed are resumed by the next advance of any remaining reader) */
+				try {
+					while (pDepth > depth)
+						fSkipTop();
 				}
+				catch (const detail::NeedsInput&) {}
 			}
 		};
 	}
 
-	/* [json::IsJson] json-reader of type [value], which can be used to read the current value (array or object-readers can only be opened once)
+	/* [json::IsJson] json-reader of type [value], which can be used to read the current value (array or object-readers can only
+	*	be opened once, and strings are only valid until the corresponding parent reader advances to the next value)
 	*	Note: This is a light-weight object, which can just be copied around, as it keeps a reference to the actual state */
 	template <json::IsReadType StreamType, char32_t CodeError>
 	class Reader : private detail::ReaderParent<StreamType, CodeError> {
 		friend class detail::ReaderState<StreamType, CodeError>;
+		friend class json::ArrReader<StreamType, CodeError>;
+		friend class json::ObjReader<StreamType, CodeError>;
 	public:
 		constexpr Reader(json::Reader<StreamType, CodeError>&&) = default;
 		constexpr Reader(const json::Reader<StreamType, CodeError>&) = default;
@@ -216,7 +417,7 @@ namespace json {
 			return std::holds_alternative<json::Bool>(*this);
 		}
 		constexpr bool isStr() const {
-			return std::holds_alternative<detail::StrReader>(*this);
+			return std::holds_alternative<detail::StrReference<StreamType, CodeError>>(*this);
 		}
 		constexpr bool isUNum() const {
 			if (std::holds_alternative<json::UNum>(*this))
@@ -242,7 +443,7 @@ namespace json {
 			case json::Type::object:
 				return std::holds_alternative<detail::ObjReference<StreamType, CodeError>>(*this);
 			case json::Type::string:
-				return std::holds_alternative<detail::StrReader>(*this);
+				return std::holds_alternative<detail::StrReference<StreamType, CodeError>>(*this);
 			case json::Type::unumber:
 				if (std::holds_alternative<json::UNum>(*this))
 					return true;
@@ -272,7 +473,7 @@ namespace json {
 		constexpr json::Type type() const {
 			if (std::holds_alternative<json::Bool>(*this))
 				return json::Type::boolean;
-			if (std::holds_alternative<detail::StrReader>(*this))
+			if (std::holds_alternative<detail::StrReference<StreamType, CodeError>>(*this))
 				return json::Type::string;
 			if (std::holds_alternative<detail::ObjReference<StreamType, CodeError>>(*this))
 				return json::Type::object;
@@ -293,10 +494,10 @@ namespace json {
 				throw json::TypeException(L"json::Reader is not a bool");
 			return std::get<json::Bool>(*this);
 		}
-		constexpr const json::Str& str() const {
-			if (!std::holds_alternative<detail::StrReader>(*this))
+		constexpr json::StrView str() const {
+			if (!std::holds_alternative<detail::StrReference<StreamType, CodeError>>(*this))
 				throw json::TypeException(L"json::Reader is not a string");
-			return *std::get<detail::StrReader>(*this);
+			return std::get<detail::StrReference<StreamType, CodeError>>(*this).value;
 		}
 		constexpr json::UNum unum() const {
 			if (std::holds_alternative<json::INum>(*this) && std::get<json::INum>(*this) >= 0)
@@ -332,20 +533,79 @@ namespace json {
 			if (!std::holds_alternative<detail::ArrReference<StreamType, CodeError>>(*this))
 				throw json::TypeException(L"json::Reader is not an array");
 			const detail::ArrReference<StreamType, CodeError>& arr = std::get<detail::ArrReference<StreamType, CodeError>>(*this);
-			return json::ArrReader<StreamType, CodeError>{ arr.state, std::move(arr.state->open(arr.stamp, false)) };
+			return json::ArrReader<StreamType, CodeError>{ arr.state, arr.state->open(arr.stamp, false), arr.stamp };
 		}
 		constexpr json::ObjReader<StreamType, CodeError> obj() const {
 			if (!std::holds_alternative<detail::ObjReference<StreamType, CodeError>>(*this))
 				throw json::TypeException(L"json::Reader is not an object");
-			const detail::ObjReference<StreamType, CodeError>& arr = std::get<detail::ObjReference<StreamType, CodeError>>(*this);
-			return json::ObjReader<StreamType, CodeError>{ arr.state, std::move(arr.state->open(arr.stamp, true)) };
+			const detail::ObjReference<StreamType, CodeError>& obj = std::get<detail::ObjReference<StreamType, CodeError>>(*this);
+			return json::ObjReader<StreamType, CodeError>{ obj.state, obj.state->open(obj.stamp, true), obj.stamp };
+		}
+
+		/* open the object to only iterate over the keys of the given set, which are matched without materializing them
+		*	(values of all other keys are skipped, and ObjReader::id() returns the id of the current key within the set)
+		*	Note: The key-set must outlive the object-reader */
+		template <size_t Count>
+		constexpr json::ObjReader<StreamType, CodeError> obj(const json::KeySet<Count>& keys) const {
+			if (!std::holds_alternative<detail::ObjReference<StreamType, CodeError>>(*this))
+				throw json::TypeException(L"json::Reader is not an object");
+			const detail::ObjReference<StreamType, CodeError>& obj = std::get<detail::ObjReference<StreamType, CodeError>>(*this);
+			return json::ObjReader<StreamType, CodeError>{ obj.state, obj.state->open(obj.stamp, true), obj.stamp, keys.entries() };
 		}
+		template <size_t Count>
+		constexpr json::ObjReader<StreamType, CodeError> obj(const json::KeySet<Count>&&) const = delete;
 
 	public:
 		/* construct a json::Value from this object */
 		constexpr json::Value value() const {
 			return json::Value{ *this };
 		}
+
+		/* construct a json::Viewer from this object, which parses arrays/objects directly into the contiguous view
+		*	(counts as opening the array/object, and it can therefore not be opened for reading anymore) */
+		constexpr json::Viewer view() const {
+			if (std::holds_alternative<detail::ArrReference<StreamType, CodeError>>(*this)) {
+				const detail::ArrReference<StreamType, CodeError>& arr = std::get<detail::ArrReference<StreamType, CodeError>>(*this);
+				return arr.state->view(arr.stamp, false);
+			}
+			if (std::holds_alternative<detail::ObjReference<StreamType, CodeError>>(*this)) {
+				const detail::ObjReference<StreamType, CodeError>& obj = std::get<detail::ObjReference<StreamType, CodeError>>(*this);
+				return obj.state->view(obj.stamp, true);
+			}
+
+			/* setup the view of the primitive value */
+			std::shared_ptr<detail::ViewState> state = std::make_shared<detail::ViewState>();
+			detail::ViewWord word = detail::ViewState::Make(detail::ViewTag::null, 0);
+			if (std::holds_alternative<detail::StrReference<StreamType, CodeError>>(*this)) {
+				state->strings = std::get<detail::StrReference<StreamType, CodeError>>(*this).value;
+				word = state->makeStr(0, state->strings.size());
+			}
+			else if (std::holds_alternative<json::UNum>(*this))
+				word = state->makeUNum(std::get<json::UNum>(*this));
+			else if (std::holds_alternative<json::INum>(*this))
+				word = state->makeINum(std::get<json::INum>(*this));
+			else if (std::holds_alternative<json::Real>(*this))
+				word = state->makeReal(std::get<json::Real>(*this));
+			else if (std::holds_alternative<json::Bool>(*this))
+				word = detail::ViewState::Make(detail::ViewTag::boolean, std::get<json::Bool>(*this) ? 1 : 0);
+			state->sync();
+			return detail::ViewAccess::Make(state, word);
+		}
+
+		/* fetch the bookmark of this array or object, from which it can be read again by json::ReadAt, independent
+		*	of whether it has already been read (bookmarks of json::AnyReader would count codepoints, and are therefore not supported) */
+		constexpr json::Bookmark bookmark() const requires(!std::is_same_v<StreamType, detail::ReadAnyType>) {
+			if (std::holds_alternative<detail::ArrReference<StreamType, CodeError>>(*this))
+				return std::get<detail::ArrReference<StreamType, CodeError>>(*this).bookmark;
+			if (!std::holds_alternative<detail::ObjReference<StreamType, CodeError>>(*this))
+				throw json::TypeException(L"json::Reader is not an array or object");
+			return std::get<detail::ObjReference<StreamType, CodeError>>(*this).bookmark;
+		}
+
+		/* create an owned copy of the string (str() is only valid until the reader advances to the next value) */
+		constexpr json::Str copyStr() const {
+			return json::Str{ str() };
+		}
 	};
 
 	/* [json::IsJson] json-reader of type [array], which can be used to read the corresponding array value
@@ -385,7 +645,7 @@ namespace json {
 				return *this;
 			}
 			constexpr bool operator==(const iterator& it) const {
-				return (pSelf.pInstance == it.pSelf.pInstance && (pEnd == it.pEnd || pSelf.closed()));
+				return (&pSelf == &it.pSelf && (pEnd == it.pEnd || pSelf.closed()));
 			}
 			constexpr bool operator!=(const iterator& it) const {
 				return !(*this == it);
@@ -394,7 +654,10 @@ namespace json {
 
 	private:
 		mutable std::shared_ptr<detail::ReaderState<StreamType, CodeError>> pState;
-		std::unique_ptr<typename detail::ReaderState<StreamType, CodeError>::Instance> pInstance;
+		size_t pDepth = 0;
+		size_t pStamp = 0;
+		mutable json::Reader<StreamType, CodeError> pValue;
+		mutable json::ReadStatus pStatus = json::ReadStatus::end;
 
 	public:
 		constexpr ArrReader() = delete;
@@ -404,20 +667,36 @@ namespace json {
 		constexpr json::ArrReader<StreamType, CodeError>& operator=(const json::ArrReader<StreamType, CodeError>&) = delete;
 		constexpr ~ArrReader() {
 			if (pState.get() != 0)
-				pState->close(pState, pInstance.get());
+				pState->close(pDepth, pStamp);
 		}
 
 	private:
-		constexpr bool fNext() const {
-			if (pState->next(pState, pInstance.get()))
-				return true;
+		constexpr json::ReadStatus fFetch() const {
+			if (pState.get() == 0)
+				return json::ReadStatus::end;
+			try {
+				if (pState->next(pDepth, pStamp)) {
+					pValue = pState->current(pState, pDepth);
+					return json::ReadStatus::value;
+				}
+			}
+			catch (const detail::NeedsInput&) {
+				pValue = json::Reader<StreamType, CodeError>{};
+				return json::ReadStatus::needsInput;
+			}
 			pState.reset();
-			return false;
+			return json::ReadStatus::end;
+		}
+		constexpr bool fNext() const {
+			pStatus = fFetch();
+			if (pStatus == json::ReadStatus::needsInput)
+				throw json::ReaderException(L"Reader requires more input to be fed");
+			return (pStatus == json::ReadStatus::value);
 		}
 
 	private:
-		constexpr ArrReader(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& state, std::unique_ptr<typename detail::ReaderState<StreamType, CodeError>::Instance>&& inst) : pState{ state }, pInstance{ std::move(inst) } {
-			fNext();
+		constexpr ArrReader(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& state, size_t depth, size_t stamp) : pState{ state }, pDepth{ depth }, pStamp{ stamp } {
+			pStatus = fFetch();
 		}
 
 	public:
@@ -431,11 +710,22 @@ namespace json {
 			return iterator{ *this, true };
 		}
 
-		/* check if a next value exists in the array and prepare it for reading */
+		/* check if a next value exists in the array and prepare it for reading (throws json::ReaderException for an exhausted json::Feed) */
 		constexpr bool next() const {
 			return fNext();
 		}
 
+		/* advance to the next value without blocking (if the last advance returned json::ReadStatus::needsInput, the reading
+		*	of the interrupted value is continued, and the first value is already being read when opening the array) */
+		constexpr json::ReadStatus advance() const {
+			return (pStatus = fFetch());
+		}
+
+		/* fetch the result of the last advance */
+		constexpr json::ReadStatus status() const {
+			return pStatus;
+		}
+
 		/* check if the end has been reached and no more valid value can therefore be read */
 		constexpr bool closed() const {
 			return (pState.get() == 0);
@@ -444,13 +734,13 @@ namespace json {
 		/* close the current object and thereby skip to the end of this array */
 		constexpr void close() const {
 			if (pState.get() != 0)
-				pState->close(pState, pInstance.get());
+				pState->close(pDepth, pStamp);
 			pState.reset();
 		}
 
 		/* read the current value (only if the reader is not marked as closed()) */
 		constexpr const json::Reader<StreamType, CodeError>& get() const {
-			return pInstance->value.second;
+			return pValue;
 		}
 	};
 
@@ -465,7 +755,7 @@ namespace json {
 			friend class json::ObjReader<StreamType, CodeError>;
 		public:
 			using iterator_category = std::input_iterator_tag;
-			using value_type = const std::pair<json::Str, json::Reader<StreamType, CodeError>>;
+			using value_type = const std::pair<json::StrView, json::Reader<StreamType, CodeError>>;
 			using pointer = value_type*;
 			using reference = value_type&;
 
@@ -491,7 +781,7 @@ namespace json {
 				return *this;
 			}
 			constexpr bool operator==(const iterator& it) const {
-				return (pSelf.pInstance == it.pSelf.pInstance && (pEnd == it.pEnd || pSelf.closed()));
+				return (&pSelf == &it.pSelf && (pEnd == it.pEnd || pSelf.closed()));
 			}
 			constexpr bool operator!=(const iterator& it) const {
 				return !(*this == it);
@@ -500,7 +790,13 @@ namespace json {
 
 	private:
 		mutable std::shared_ptr<detail::ReaderState<StreamType, CodeError>> pState;
-		std::unique_ptr<typename detail::ReaderState<StreamType, CodeError>::Instance> pInstance;
+		size_t pDepth = 0;
+		size_t pStamp = 0;
+		mutable std::pair<json::StrView, json::Reader<StreamType, CodeError>> pValue = { json::StrView{}, json::Reader<StreamType, CodeError>{} };
+		std::span<const detail::KeyEntry> pKeys;
+		mutable size_t pId = json::UnknownKey;
+		mutable json::ReadStatus pStatus = json::ReadStatus::end;
+		bool pFiltered = false;
 
 	public:
 		constexpr ObjReader() = delete;
@@ -510,20 +806,82 @@ namespace json {
 		constexpr json::ObjReader<StreamType, CodeError>& operator=(const json::ObjReader<StreamType, CodeError>&) = delete;
 		constexpr ~ObjReader() {
 			if (pState.get() != 0)
-				pState->close(pState, pInstance.get());
+				pState->close(pDepth, pStamp);
 		}
 
 	private:
+		constexpr json::ReadStatus fFetch() const {
+			if (pState.get() == 0)
+				return json::ReadStatus::end;
+			try {
+				/* check if only the keys of the key-set are to be read */
+				if (pFiltered) {
+					if (const detail::KeyEntry* entry = pState->nextOf(pDepth, pStamp, pKeys); entry != nullptr) {
+						pId = entry->id;
+						pValue = { entry->key, pState->current(pState, pDepth) };
+						return json::ReadStatus::value;
+					}
+				}
+				else if (pState->next(pDepth, pStamp)) {
+					pValue = { pState->key(pDepth), pState->current(pState, pDepth) };
+					return json::ReadStatus::value;
+				}
+			}
+			catch (const detail::NeedsInput&) {
+				pId = json::UnknownKey;
+				pValue = { json::StrView{}, json::Reader<StreamType, CodeError>{} };
+				return json::ReadStatus::needsInput;
+			}
+			pId = json::UnknownKey;
+			pState.reset();
+			return json::ReadStatus::end;
+		}
 		constexpr bool fNext() const {
-			if (pState->next(pState, pInstance.get()))
-				return true;
+			pStatus = fFetch();
+			if (pStatus == json::ReadStatus::needsInput)
+				throw json::ReaderException(L"Reader requires more input to be fed");
+			return (pStatus == json::ReadStatus::value);
+		}
+		template <size_t Count>
+		constexpr std::array<json::Value, Count> fExtract(const json::KeySet<Count>& keys, const json::Type* types) const {
+			std::array<json::Value, Count> out;
+			auto assign = [&](size_t id, const json::Reader<StreamType, CodeError>& value) {
+				if (types == nullptr || value.is(types[id]))
+					out[id] = value.value();
+				else
+					out[id] = json::Null();
+			};
+
+			/* consume the current value and match the keys of all remaining entries directly, while skipping all other values */
+			if (pStatus == json::ReadStatus::value) {
+				if (size_t id = keys.id(pValue.first); id != json::UnknownKey)
+					assign(id, pValue.second);
+			}
+			try {
+				while (pState.get() != 0) {
+					const detail::KeyEntry* entry = pState->nextOf(pDepth, pStamp, keys.entries());
+					if (entry == nullptr)
+						break;
+					assign(entry->id, pState->current(pState, pDepth));
+				}
+			}
+			catch (const detail::NeedsInput&) {
+				throw json::ReaderException(L"Reader requires more input to be fed");
+			}
+
+			pId = json::UnknownKey;
+			pValue = { json::StrView{}, json::Reader<StreamType, CodeError>{} };
+			pStatus = json::ReadStatus::end;
 			pState.reset();
-			return false;
+			return out;
 		}
 
 	private:
-		constexpr ObjReader(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& state, std::unique_ptr<typename detail::ReaderState<StreamType, CodeError>::Instance>&& inst) : pState{ state }, pInstance{ std::move(inst) } {
-			fNext();
+		constexpr ObjReader(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& state, size_t depth, size_t stamp) : pState{ state }, pDepth{ depth }, pStamp{ stamp } {
+			pStatus = fFetch();
+		}
+		constexpr ObjReader(const std::shared_ptr<detail::ReaderState<StreamType, CodeError>>& state, size_t depth, size_t stamp, std::span<const detail::KeyEntry> keys) : pState{ state }, pDepth{ depth }, pStamp{ stamp }, pKeys{ keys }, pFiltered{ true } {
+			pStatus = fFetch();
 		}
 
 	public:
@@ -537,11 +895,22 @@ namespace json {
 			return iterator{ *this, true };
 		}
 
-		/* check if a next value exists in the object and prepare it for reading */
+		/* check if a next value exists in the object and prepare it for reading (throws json::ReaderException for an exhausted json::Feed) */
 		constexpr bool next() const {
 			return fNext();
 		}
 
+		/* advance to the next value without blocking (if the last advance returned json::ReadStatus::needsInput, the reading
+		*	of the interrupted value is continued, and the first value is already being read when opening the object) */
+		constexpr json::ReadStatus advance() const {
+			return (pStatus = fFetch());
+		}
+
+		/* fetch the result of the last advance */
+		constexpr json::ReadStatus status() const {
+			return pStatus;
+		}
+
 		/* check if the end has been reached and no more valid value can therefore be read */
 		constexpr bool closed() const {
 			return (pState.get() == 0);
@@ -550,30 +919,49 @@ namespace json {
 		/* close the current object and thereby skip to the end of this object */
 		constexpr void close() const {
 			if (pState.get() != 0)
-				pState->close(pState, pInstance.get());
+				pState->close(pDepth, pStamp);
 			pState.reset();
 		}
 
-		/* read the current key (only if the reader is not marked as closed()) */
-		constexpr const json::Str& key() const {
-			return pInstance->key;
+		/* read the current key (only if the reader is not marked as closed(), and only valid until the reader advances) */
+		constexpr json::StrView key() const {
+			return pValue.first;
 		}
 
 		/* read the current value (only if the reader is not marked as closed()) */
 		constexpr const json::Reader<StreamType, CodeError>& value() const {
-			return pInstance->value;
+			return pValue.second;
 		}
 
-		/* read the current value (only if the reader is not marked as closed()) */
-		constexpr const std::pair<json::Str, json::Reader<StreamType, CodeError>>& get() const {
-			return pInstance->value;
+		/* read the id of the current key within the json::KeySet the object was opened with (json::UnknownKey otherwise) */
+		constexpr size_t id() const {
+			return pId;
+		}
+
+		/* read the values of all keys of the set from the current and all remaining entries in a single pass, indexed by their ids, and close
+		*	the object (keys are matched without materializing them, and all other values are skipped without being decoded)
+		*	- keys, which are missing or whose values are not convertible to the optional type of their id, are null
+		*	- for objects with multiple identical keys, the last occurring value will be used
+		*	- throws json::ReaderException for an exhausted json::Feed */
+		template <size_t Count>
+		constexpr std::array<json::Value, Count> extract(const json::KeySet<Count>& keys) const {
+			return fExtract(keys, nullptr);
+		}
+		template <size_t Count>
+		constexpr std::array<json::Value, Count> extract(const json::KeySet<Count>& keys, const std::array<json::Type, Count>& types) const {
+			return fExtract(keys, types.data());
+		}
+
+		/* read the current key and value (only if the reader is not marked as closed(), and key only valid until the reader advances) */
+		constexpr const std::pair<json::StrView, json::Reader<StreamType, CodeError>>& get() const {
+			return pValue;
 		}
 	};
 
 	/* construct a json value-reader from the given stream and ensure that the entire stream is a single valid
 	*	json-value and parse and validate the json along reading it instead of parsing it in its entirety beforehand
 	*	Note: Must not outlive the stream as it may store a reference to it */
-	template <str::IsStream StreamType, char32_t CodeError = str::err::DefChar>
+	template <json::IsInput StreamType, char32_t CodeError = str::err::DefChar>
 	constexpr json::Reader<std::remove_reference_t<StreamType>, CodeError> Read(StreamType&& stream) {
 		using ActStream = std::remove_reference_t<StreamType>;
 
@@ -582,7 +970,40 @@ namespace json {
 		return state->initValue(state);
 	}
 
-	/* same as json::Reader, but uses inheritance to hide the underlying stream-type
+	/* construct a json value-reader for the value at the bookmark of a previous reader of the same stream, which
+	*	must either be string-like or seekable (only the value itself is read and validated, and anything following it
+	*	is ignored, while bookmarks of the new reader remain consistent with the bookmarks of the original reading)
+	*	Note: Must not outlive the stream as it may store a reference to it, and seekable streams must not be read at a bookmark
+	*	while the original reader is still alive, as the seek moves the position under a reader, which may have buffered ahead */
+	template <str::IsStream StreamType, char32_t CodeError = str::err::DefChar>
+	constexpr auto ReadAt(StreamType&& stream, const json::Bookmark& bookmark) {
+		if constexpr (str::IsStr<StreamType>) {
+			/* read the string-like stream from the offset (rvalue strings are copied, as they cannot be referenced) */
+			std::basic_string_view<str::StringChar<StreamType>> view{ stream };
+			if (bookmark.offset > view.size())
+				throw json::RangeException(L"Bookmark is out of range of the stream");
+			using ActStream = std::conditional_t<std::is_lvalue_reference_v<StreamType>, decltype(view), std::basic_string<str::StringChar<StreamType>>>;
+
+			auto state = std::make_shared<detail::ReaderState<ActStream, CodeError>>(ActStream{ view.substr(bookmark.offset) }, bookmark);
+			return state->initValue(state);
+		}
+		else {
+			static_assert(requires(StreamType s) { s.seekg(std::streamoff(0)); }, "Stream must be string-like or seekable to be read at a bookmark");
+			using ActStream = std::remove_reference_t<StreamType>;
+
+			/* seek the stream to the offset (which already contains the position, at which the original reading started), after
+			*	clearing the state, as the original reading has usually reached the end of the stream, which would reject the seek */
+			stream.clear();
+			if (!stream.seekg(std::streamoff(bookmark.offset)))
+				throw json::RangeException(L"Bookmark is out of range of the stream");
+
+			auto state = std::make_shared<detail::ReaderState<ActStream, CodeError>>(std::forward<StreamType>(stream), bookmark);
+			return state->initValue(state);
+		}
+	}
+
+	/* same as json::Reader, but uses inheritance to hide the underlying stream-type (codepoints
+	*	are decoded in blocks, and might therefore be fetched from the stream ahead of time)
 	*	Note: This is a light-weight object, which can just be copied around, as it keeps a reference to the actual state */
 	using AnyReader = json::Reader<detail::ReadAnyType, str::err::DefChar>;
 
@@ -602,10 +1023,37 @@ namespace json {
 		using ActStream = std::remove_reference_t<StreamType>;
 
 		/* wrap the stream to be held by the reader */
-		std::unique_ptr<str::InheritStream> readStream = std::make_unique<str::StreamImplementation<ActStream>>(std::forward<StreamType>(stream));
+		std::unique_ptr<detail::BlockSource> readStream = std::make_unique<detail::BlockSourceImpl<ActStream, str::err::DefChar>>(std::forward<StreamType>(stream));
 
 		/* setup the first state and fetch the initial value */
 		auto state = std::make_shared<detail::ReaderState<detail::ReadAnyType, str::err::DefChar>>(std::move(readStream));
 		return state->initValue(state);
 	}
+
+	/* same as json::Reader, but reads from a caller-fed json::Feed without blocking (use advance() on the
+	*	array and object-readers to read the values, which reports json::ReadStatus::needsInput for an exhausted feed)
+	*	Note: This is a light-weight object, which can just be copied around, as it keeps a reference to the actual state */
+	using FeedReader = json::Reader<json::Feed, str::err::DefChar>;
+
+	/* same as json::ObjReader, but reads from a caller-fed json::Feed without blocking
+	*	Note: Although this is a light-weight object, it can only be moved around, as it references the current progress of the reading */
+	using FeedObjReader = json::ObjReader<json::Feed, str::err::DefChar>;
+
+	/* same as json::ArrReader, but reads from a caller-fed json::Feed without blocking
+	*	Note: Although this is a light-weight object, it can only be moved around, as it references the current progress of the reading */
+	using FeedArrReader = json::ArrReader<json::Feed, str::err::DefChar>;
+
+	/* construct a json feed-reader from the given feed, or return an empty optional, if more input needs to
+	*	be fed before the first value can be read (primitive root-values require the feed to be closed)
+	*	Note: Must not outlive the feed as it stores a reference to it */
+	inline std::optional<json::FeedReader> ReadFeed(json::Feed& feed) {
+		/* setup the first state and try to fetch the initial value (nothing has been consumed, if it fails) */
+		auto state = std::make_shared<detail::ReaderState<json::Feed, str::err::DefChar>>(feed);
+		try {
+			return state->initValue(state);
+		}
+		catch (const detail::NeedsInput&) {
+			return std::nullopt;
+		}
+	}
 }
@@ -0,0 +1,428 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include "json-common.h"
+#include "json-deserializer.h"
+#include "json-cbor.h"
+#include "json-msgpack.h"
+#include "json-deserialize.h"
+#include "json-value.h"
+
+namespace json {
+	namespace detail {
+		template <class StreamType, char32_t CodeError>
+		class SchemaDeserializer;
+	}
+
+	/* compiled subset of json-schema, which is validated while deserializing, and aborts on the first violation
+	*	- supported keywords: type, enum, const, minimum, maximum, exclusiveMinimum, exclusiveMaximum (numeric and boolean form),
+	*		minLength, maxLength, minItems, maxItems, items (single schema), required, properties, additionalProperties
+	*	- annotations ($schema, $id, $comment, title, description, default, examples, format) are ignored
+	*	- all other keywords are rejected, to prevent a schema from silently being validated weaker than intended */
+	class Schema {
+		template <class StreamType, char32_t CodeError>
+		friend class detail::SchemaDeserializer;
+	private:
+		/* types as bit-mask (integers are numbers without fraction, and are therefore also matched by number) */
+		static constexpr uint8_t TypeNull = 0x01;
+		static constexpr uint8_t TypeBoolean = 0x02;
+		static constexpr uint8_t TypeInteger = 0x04;
+		static constexpr uint8_t TypeNumber = 0x08;
+		static constexpr uint8_t TypeString = 0x10;
+		static constexpr uint8_t TypeArray = 0x20;
+		static constexpr uint8_t TypeObject = 0x40;
+		static constexpr uint8_t TypeAny = 0x7f;
+
+		/* node-ids of the boolean schemas [true] and [false] */
+		static constexpr size_t Accept = size_t(-1);
+		static constexpr size_t Reject = size_t(-2);
+
+		/* keys of an object, which are either properties with a schema, or required, or both */
+		struct Key {
+			json::Str key;
+			size_t node = Schema::Accept;
+			size_t slot = 0;
+			bool property = false;
+			bool required = false;
+		};
+		struct Node {
+			std::vector<Key> keys;
+			std::vector<json::Value> values;
+			json::Real minimum = -std::numeric_limits<json::Real>::infinity();
+			json::Real maximum = std::numeric_limits<json::Real>::infinity();
+			json::Real exclusiveMinimum = -std::numeric_limits<json::Real>::infinity();
+			json::Real exclusiveMaximum = std::numeric_limits<json::Real>::infinity();
+			size_t minLength = 0;
+			size_t maxLength = std::numeric_limits<size_t>::max();
+			size_t minItems = 0;
+			size_t maxItems = std::numeric_limits<size_t>::max();
+			size_t required = 0;
+			size_t additional = Schema::Accept;
+			size_t items = Schema::Accept;
+			uint8_t types = Schema::TypeAny;
+			bool enumerated = false;
+		};
+
+	private:
+		std::vector<Node> pNodes;
+		size_t pRoot = Schema::Accept;
+
+	public:
+		Schema() = default;
+		Schema(const json::Value& schema) {
+			pRoot = fCompile(schema, L"");
+		}
+
+	private:
+		static uint8_t fType(const json::Value& type, const json::Str& path) {
+			if (!type.isStr())
+				throw json::SchemaException(L"Schema-type at [", path, L"] must be a string");
+			const json::Str& name = type.str();
+			if (name == L"null")
+				return Schema::TypeNull;
+			if (name == L"boolean")
+				return Schema::TypeBoolean;
+			if (name == L"integer")
+				return Schema::TypeInteger;
+			if (name == L"number")
+				return Schema::TypeNumber | Schema::TypeInteger;
+			if (name == L"string")
+				return Schema::TypeString;
+			if (name == L"array")
+				return Schema::TypeArray;
+			if (name == L"object")
+				return Schema::TypeObject;
+			throw json::SchemaException(L"Unknown schema-type [", name, L"] at [", path, L"]");
+		}
+		static json::Real fNumber(const json::Value& value, const json::Str& path) {
+			if (!value.isReal())
+				throw json::SchemaException(L"Schema-keyword at [", path, L"] must be a number");
+			return value.real();
+		}
+		static size_t fCount(const json::Value& value, const json::Str& path) {
+			if (!value.isUNum())
+				throw json::SchemaException(L"Schema-keyword at [", path, L"] must be a non-negative integer");
+			return size_t(value.unum());
+		}
+		static Key& fKey(Node& node, const json::Str& key) {
+			for (Key& entry : node.keys) {
+				if (entry.key == key)
+					return entry;
+			}
+			return node.keys.emplace_back(Key{ key });
+		}
+		static json::Str fPointer(const json::Str& path, const json::Str& key) {
+			/* escape the key as json-pointer token */
+			json::Str out = path + L"/";
+			for (wchar_t c : key) {
+				if (c == L'~')
+					out.append(L"~0");
+				else if (c == L'/')
+					out.append(L"~1");
+				else
+					out.push_back(c);
+			}
+			return out;
+		}
+		size_t fCompile(const json::Value& schema, const json::Str& path) {
+			if (schema.isBoolean())
+				return (schema.boolean() ? Schema::Accept : Schema::Reject);
+			if (!schema.isObj())
+				throw json::SchemaException(L"Schema at [", path, L"] must be an object or a boolean");
+
+			/* allocate the node upfront, but populate it locally, as nested schemas reallocate the nodes */
+			size_t id = pNodes.size();
+			pNodes.emplace_back();
+			Node node;
+			bool minimumFlag = false, maximumFlag = false;
+
+			for (const auto& [keyword, value] : schema.obj()) {
+				json::Str at = fPointer(path, keyword);
+
+				if (keyword == L"type") {
+					node.types = 0;
+					if (!value.isArr())
+						node.types = fType(value, at);
+					else for (const json::Value& type : value.arr())
+						node.types |= fType(type, at);
+				}
+				else if (keyword == L"enum" || keyword == L"const") {
+					if (keyword == L"enum" && !value.isArr())
+						throw json::SchemaException(L"Schema-enum at [", at, L"] must be an array");
+					node.values = (keyword == L"enum" ? value.arr() : json::Arr{ value });
+					node.enumerated = true;
+				}
+				else if (keyword == L"minimum")
+					node.minimum = fNumber(value, at);
+				else if (keyword == L"maximum")
+					node.maximum = fNumber(value, at);
+
+				/* exclusive bounds are either numbers, or flags which mark the regular bounds as exclusive (draft-04) */
+				else if (keyword == L"exclusiveMinimum") {
+					if (value.isBoolean())
+						minimumFlag = value.boolean();
+					else
+						node.exclusiveMinimum = fNumber(value, at);
+				}
+				else if (keyword == L"exclusiveMaximum") {
+					if (value.isBoolean())
+						maximumFlag = value.boolean();
+					else
+						node.exclusiveMaximum = fNumber(value, at);
+				}
+				else if (keyword == L"minLength")
+					node.minLength = fCount(value, at);
+				else if (keyword == L"maxLength")
+					node.maxLength = fCount(value, at);
+				else if (keyword == L"minItems")
+					node.minItems = fCount(value, at);
+				else if (keyword == L"maxItems")
+					node.maxItems = fCount(value, at);
+				else if (keyword == L"items") {
+					if (value.isArr())
+						throw json::SchemaException(L"Schema-items at [", at, L"] as array of schemas are not supported");
+					node.items = fCompile(value, at);
+				}
+				else if (keyword == L"required") {
+					if (!value.isArr())
+						throw json::SchemaException(L"Schema-required at [", at, L"] must be an array");
+					for (const json::Value& key : value.arr()) {
+						if (!key.isStr())
+							throw json::SchemaException(L"Schema-required at [", at, L"] must only contain strings");
+						fKey(node, key.str()).required = true;
+					}
+				}
+				else if (keyword == L"properties") {
+					if (!value.isObj())
+						throw json::SchemaException(L"Schema-properties at [", at, L"] must be an object");
+					for (const auto& [key, property] : value.obj()) {
+						size_t child = fCompile(property, fPointer(at, key));
+						Key& entry = fKey(node, key);
+						entry.node = child;
+						entry.property = true;
+					}
+				}
+				else if (keyword == L"additionalProperties")
+					node.additional = fCompile(value, at);
+				else if (keyword != L"$schema" && keyword != L"$id" && keyword != L"id" && keyword != L"$comment" && keyword != L"title" &&
+					keyword != L"description" && keyword != L"default" && keyword != L"examples" && keyword != L"format")
+					throw json::SchemaException(L"Unsupported schema-keyword at [", at, L"]");
+			}
+
+			/* apply the draft-04 flags to the bounds */
+			if (minimumFlag) {
+				node.exclusiveMinimum = std::max(node.exclusiveMinimum, node.minimum);
+				node.minimum = -std::numeric_limits<json::Real>::infinity();
+			}
+			if (maximumFlag) {
+				node.exclusiveMaximum = std::min(node.exclusiveMaximum, node.maximum);
+				node.maximum = std::numeric_limits<json::Real>::infinity();
+			}
+
+			/* sort the keys for the lookup while deserializing and assign the slots of the required keys */
+			std::sort(node.keys.begin(), node.keys.end(), [](const Key& a, const Key& b) { return a.key < b.key; });
+			for (Key& entry : node.keys) {
+				if (entry.required)
+					entry.slot = node.required++;
+			}
+			pNodes[id] = std::move(node);
+			return id;
+		}
+	};
+
+	namespace detail {
+		template <class StreamType, char32_t CodeError>
+		class SchemaDeserializer {
+		private:
+			/* key or index of the values currently being read (only formatted upon violations) */
+			struct PathEntry {
+				const json::Str* key = nullptr;
+				size_t index = 0;
+			};
+
+		private:
+			detail::Deserializer<StreamType, CodeError>& pDeserializer;
+			const json::Schema& pSchema;
+			std::vector<PathEntry> pPath;
+			std::vector<uint8_t> pSeen;
+
+		private:
+			template <class... Args>
+			void fViolation(const Args&... args) {
+				/* format the path as json-pointer */
+				json::Str pointer;
+				for (const PathEntry& entry : pPath) {
+					if (entry.key == nullptr)
+						pointer.append(L"/").append(std::to_wstring(entry.index));
+					else
+						pointer = json::Schema::fPointer(pointer, *entry.key);
+				}
+				throw json::SchemaException(L"Value at [", pointer, L"] violates the schema: ", args...);
+			}
+			static constexpr size_t fLength(const json::Str& s) {
+				/* count the codepoints (low surrogates are part of the previous codepoint on platforms with 2-byte wchar_t) */
+				if constexpr (sizeof(wchar_t) != 2)
+					return s.size();
+				size_t count = 0;
+				for (wchar_t c : s)
+					count += (c < 0xdc00 || c > 0xdfff) ? 1 : 0;
+				return count;
+			}
+			constexpr void fObject(json::Obj& out, const json::Schema::Node& self) {
+				size_t base = pSeen.size();
+				pSeen.resize(base + self.required, 0);
+
+				if (!pDeserializer.checkIsEmpty(true)) {
+					do {
+						/* read the key and lookup its schema (keys which are not properties fall back to the additional properties) */
+						json::Str key;
+						pDeserializer.readString(key, true);
+						auto it = std::lower_bound(self.keys.begin(), self.keys.end(), key, [](const json::Schema::Key& entry, const json::Str& k) { return entry.key < k; });
+						size_t child = self.additional;
+						if (it != self.keys.end() && it->key == key) {
+							if (it->required)
+								pSeen[base + it->slot] = 1;
+							if (it->property)
+								child = it->node;
+						}
+
+						/* read the value into a reset slot, as the previous value of duplicate keys is replaced, and check if the end has been reached */
+						json::Value& value = out[key];
+						value = json::Null();
+						pPath.push_back(PathEntry{ &key, 0 });
+						fValue(value, child);
+						pPath.pop_back();
+					} while (!pDeserializer.closeElseSeparator(true));
+				}
+
+				/* check if all required keys have been encountered */
+				for (const json::Schema::Key& entry : self.keys) {
+					if (entry.required && pSeen[base + entry.slot] == 0)
+						fViolation(L"required key [", entry.key, L"] is missing");
+				}
+				pSeen.resize(base);
+			}
+			constexpr void fArray(json::Arr& out, const json::Schema::Node& self) {
+				if (!pDeserializer.checkIsEmpty(false)) {
+					/* read the value and check if the end has been reached (aborts as soon as too many values have been read) */
+					do {
+						if (out.size() >= self.maxItems)
+							fViolation(L"more than ", self.maxItems, L" items");
+						pPath.push_back(PathEntry{ nullptr, out.size() });
+						fValue(out.emplace_back(), self.items);
+						pPath.pop_back();
+					} while (!pDeserializer.closeElseSeparator(false));
+				}
+				if (out.size() < self.minItems)
+					fViolation(L"less than ", self.minItems, L" items");
+			}
+			constexpr void fNumber(json::Value& out, const json::Schema::Node& self) {
+				detail::NumberValue value = pDeserializer.readNumber();
+				json::Real real = 0;
+				bool integer = true;
+				if (std::holds_alternative<json::INum>(value)) {
+					out = std::get<json::INum>(value);
+					real = json::Real(std::get<json::INum>(value));
+				}
+				else if (std::holds_alternative<json::UNum>(value)) {
+					out = std::get<json::UNum>(value);
+					real = json::Real(std::get<json::UNum>(value));
+				}
+				else {
+					out = std::get<json::Real>(value);
+					real = std::get<json::Real>(value);
+					integer = (std::isfinite(real) && std::trunc(real) == real);
+				}
+
+				/* numbers are only typed once read, as the tokens do not distinguish them */
+				if ((self.types & (integer ? json::Schema::TypeInteger : json::Schema::TypeNumber)) == 0)
+					fViolation(L"unexpected type");
+				if (real < self.minimum || real > self.maximum || real <= self.exclusiveMinimum || real >= self.exclusiveMaximum)
+					fViolation(L"number is out of range");
+			}
+			constexpr void fValue(json::Value& out, size_t node) {
+				/* values without any constraints are deserialized without validation */
+				if (node == json::Schema::Accept) {
+					detail::JsonDeserializer<StreamType, CodeError>{ pDeserializer }.read(out);
+					return;
+				}
+				if (node == json::Schema::Reject)
+					fViolation(L"no value is allowed");
+				const json::Schema::Node& self = pSchema.pNodes[node];
+
+				/* check the type before reading the value (containers have already been opened at this point) */
+				json::Type type = pDeserializer.peekOrOpenNext();
+				uint8_t mask = json::Schema::TypeNumber | json::Schema::TypeInteger;
+				if (type == json::Type::string)
+					mask = json::Schema::TypeString;
+				else if (type == json::Type::object)
+					mask = json::Schema::TypeObject;
+				else if (type == json::Type::array)
+					mask = json::Schema::TypeArray;
+				else if (type == json::Type::boolean)
+					mask = json::Schema::TypeBoolean;
+				else if (type == json::Type::null)
+					mask = json::Schema::TypeNull;
+				if ((self.types & mask) == 0)
+					fViolation(L"unexpected type");
+
+				switch (type) {
+				case json::Type::string: {
+					pDeserializer.readString(out.str(), false);
+					size_t length = fLength(out.str());
+					if (length < self.minLength || length > self.maxLength)
+						fViolation(L"string length is out of range");
+					break;
+				}
+				case json::Type::object:
+					fObject(out.obj(), self);
+					break;
+				case json::Type::array:
+					fArray(out.arr(), self);
+					break;
+				case json::Type::boolean:
+					out = pDeserializer.readBoolean();
+					break;
+				case json::Type::inumber:
+				case json::Type::unumber:
+				case json::Type::real:
+					fNumber(out, self);
+					break;
+				case json::Type::null:
+				default:
+					out = pDeserializer.readNull();
+					break;
+				}
+
+				/* check the completed value against the enumerated values */
+				if (self.enumerated && std::find(self.values.begin(), self.values.end(), out) == self.values.end())
+					fViolation(L"value is not one of the enumerated values");
+			}
+
+		public:
+			constexpr SchemaDeserializer(detail::Deserializer<StreamType, CodeError>& deserializer, const json::Schema& schema) : pDeserializer{ deserializer }, pSchema{ schema } {}
+
+		public:
+			constexpr void read(json::Value& out) {
+				fValue(out, pSchema.pRoot);
+			}
+		};
+	}
+
+	/* deserialize the stream to a json::Value, while validating it against the schema, and abort with a json::SchemaException
+	*	on the first violation (values are validated as they are read, and the remainder of the stream is not read anymore)
+	*	- interprets \u escape-sequences as utf-16 encoding
+	*	- expects entire stream to be a single json value until the end with optional whitespace padding
+	*	- for objects with multiple identical keys, each value is validated, but the last occurring value will be used */
+	template <char32_t CodeError = str::err::DefChar>
+	constexpr json::Value Deserialize(json::IsInput auto&& stream, const json::Schema& schema) {
+		using StreamType = decltype(stream);
+
+		detail::Deserializer<std::remove_reference_t<StreamType>, CodeError> deserializer{ std::forward<StreamType>(stream) };
+		json::Value out;
+		detail::SchemaDeserializer<std::remove_reference_t<StreamType>, CodeError>{ deserializer, schema }.read(out);
+		deserializer.checkDone();
+		return out;
+	}
+}
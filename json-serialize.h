@@ -4,6 +4,8 @@
 
 #include "json-common.h"
 #include "json-serializer.h"
+#include "json-cbor.h"
+#include "json-msgpack.h"
 
 namespace json {
 	namespace detail {
@@ -76,7 +78,7 @@ namespace json {
 	/* serialize the json-like object to the sink and return it (indentation will be sanitized to
 	*	only contain spaces and tabs, if indentation is empty, a compact json stream will be produced) */
 	template <char32_t CodeError = str::err::DefChar>
-	constexpr auto& SerializeTo(str::IsSink auto&& sink, const json::IsJson auto& value, const std::wstring_view& indent = L"\t") {
+	constexpr auto& SerializeTo(json::IsOutput auto&& sink, const json::IsJson auto& value, const std::wstring_view& indent = L"\t") {
 		detail::JsonSerializer<decltype(sink), CodeError> _serializer{ sink, indent, value };
 		return sink;
 	}
@@ -5,6 +5,27 @@
 #include "json-common.h"
 
 namespace json::detail {
+	/* type-erased sink, which receives entire blocks of codepoints, to only require one virtual call per block */
+	struct BlockSink {
+		virtual ~BlockSink() = default;
+		virtual void write(const std::u32string_view& block) = 0;
+	};
+
+	template <class SinkType, char32_t CodeError>
+	class BlockSinkImpl final : public detail::BlockSink {
+	private:
+		SinkType pSink;
+
+	public:
+		template <class Type>
+		constexpr BlockSinkImpl(Type&& sink) : pSink{ std::forward<Type>(sink) } {}
+
+	public:
+		void write(const std::u32string_view& block) override {
+			str::TranscodeAllTo<CodeError>(pSink, block);
+		}
+	};
+
 	template <class SinkType, char32_t CodeError>
 	class Serializer {
 	private:
@@ -82,6 +103,9 @@ namespace json::detail {
 		}
 
 	public:
+		constexpr SinkType& sink() {
+			return pSink;
+		}
 		constexpr void primitive(const auto& v) {
 			using VType = std::remove_cvref_t<decltype(v)>;
 
@@ -132,6 +156,25 @@ namespace json::detail {
 			/* add the newline for the next value */
 			fNewline();
 		}
+		constexpr void arrayValues(const auto& values) {
+			/* prepare the separator once, as the depth cannot change while writing the values out */
+			std::wstring separator = L",";
+			if (!pIndent.empty()) {
+				separator.push_back(L'\n');
+				for (size_t i = 0; i < pDepth; ++i)
+					separator.append(pIndent);
+			}
+
+			/* write all values out (the first value might not require a separator) */
+			for (const auto& value : values) {
+				if (pAlreadyHasValue)
+					str::TranscodeAllTo<CodeError>(pSink, separator);
+				else
+					fNewline();
+				pAlreadyHasValue = true;
+				primitive(value);
+			}
+		}
 		constexpr void end(bool obj) {
 			--pDepth;
 
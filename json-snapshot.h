@@ -0,0 +1,392 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+/* Copyright (c) 2024 Bjoern Boss Henrichsen */
+#pragma once
+
+#include "json-common.h"
+#include "json-serializer.h"
+#include "json-viewer.h"
+
+#include <filesystem>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace json {
+	namespace detail {
+		/* header of a viewer-image, which is followed by the words of the tape and the units of the string-pool
+		*	(all indices are relative to the tape/string-pool, and the image is therefore position-independent) */
+		struct ViewImageHeader {
+			uint64_t magic = 0;
+			uint64_t version = 0;
+			uint64_t layout = 0;
+			uint64_t utf8 = 0;
+			uint64_t root = 0;
+			uint64_t words = 0;
+			uint64_t units = 0;
+		};
+		static constexpr uint64_t ViewImageMagic = 0x776569766e6f736aull;
+		static constexpr uint64_t ViewImageVersion = 1;
+
+		/* layout of the values within the image (images use the native encoding, and can only be loaded on compatible
+		*	systems, which is verified by the byte-order marker and the sizes of the string-units and reals) */
+		static constexpr uint64_t ViewImageLayout = (uint64_t(0x01020304) << 32) | (uint64_t(sizeof(wchar_t)) << 16) | (uint64_t(sizeof(json::Real)) << 8) | uint64_t(detail::ViewTagShift);
+
+		inline std::shared_ptr<const void> MapImage(const std::filesystem::path& path, size_t& size) {
+#if defined(_WIN32)
+			HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+				throw json::SnapshotException(L"Unable to open viewer-image [", path.wstring(), L"]");
+
+			/* fetch the size and map the entire file (the mapping keeps the file referenced) */
+			LARGE_INTEGER fileSize{};
+			HANDLE mapping = nullptr;
+			if (::GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+				mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			::CloseHandle(file);
+			if (mapping == nullptr)
+				throw json::SnapshotException(L"Unable to map viewer-image [", path.wstring(), L"]");
+			const void* data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			::CloseHandle(mapping);
+			if (data == nullptr)
+				throw json::SnapshotException(L"Unable to map viewer-image [", path.wstring(), L"]");
+
+			size = size_t(fileSize.QuadPart);
+			return std::shared_ptr<const void>{ data, [](const void* p) { ::UnmapViewOfFile(p); } };
+#else
+			int file = ::open(path.c_str(), O_RDONLY);
+			if (file < 0)
+				throw json::SnapshotException(L"Unable to open viewer-image [", path.wstring(), L"]");
+
+			/* fetch the size and map the entire file (the mapping keeps the file referenced) */
+			struct stat info {};
+			void* data = MAP_FAILED;
+			if (::fstat(file, &info) == 0 && info.st_size > 0)
+				data = ::mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_SHARED, file, 0);
+			::close(file);
+			if (data == MAP_FAILED)
+				throw json::SnapshotException(L"Unable to map viewer-image [", path.wstring(), L"]");
+
+			size = size_t(info.st_size);
+			return std::shared_ptr<const void>{ data, [size](const void* p) { ::munmap(const_cast<void*>(p), size); } };
+#endif
+		}
+
+		template <json::IsByteSink SinkType>
+		void WriteImage(SinkType& sink, const detail::ViewState* state, detail::ViewWord root) {
+			/* setup the header (default viewers do not have a state and are null) */
+			detail::ViewImageHeader header{ detail::ViewImageMagic, detail::ViewImageVersion, detail::ViewImageLayout };
+			header.root = root;
+			if (state != nullptr && state->lazy != nullptr)
+				throw json::SnapshotException(L"Lazy viewers cannot be written as viewer-image");
+			if (state != nullptr) {
+				header.utf8 = (state->utf8 ? 1 : 0);
+				header.words = state->words.size();
+				header.units = (state->utf8 ? state->source.size() + state->escaped.size() : state->chars.size());
+			}
+
+			/* write the header, tape and string-pool out (the string-pool of utf-8 viewers is the source followed by the escaped strings) */
+			detail::WriteBytes(sink, reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+			if (state == nullptr)
+				return;
+			detail::WriteBytes(sink, reinterpret_cast<const uint8_t*>(state->words.data()), state->words.size_bytes());
+			if (state->utf8) {
+				detail::WriteBytes(sink, reinterpret_cast<const uint8_t*>(state->source.data()), state->source.size());
+				detail::WriteBytes(sink, reinterpret_cast<const uint8_t*>(state->escaped.data()), state->escaped.size());
+			}
+			else
+				detail::WriteBytes(sink, reinterpret_cast<const uint8_t*>(state->chars.data()), state->chars.size() * sizeof(wchar_t));
+		}
+
+		inline void ValidateImage(const detail::ViewState& state, detail::ViewWord root, const std::wstring& name) {
+			/* validate every word reachable from the root once, such that no access of the viewer can leave the tape or string-pool
+			*	(images are used for inter-process communication and caches, and might therefore be truncated or hostile) */
+			size_t words = state.words.size(), units = (state.utf8 ? state.source.size() : state.chars.size());
+			auto fail = [&]() { throw json::SnapshotException(L"Viewer-image [", name, L"] is malformed"); };
+			auto string = [&](size_t offset, size_t length) {
+				if (offset > units || length > units - offset)
+					fail();
+			};
+
+			/* containers are only validated once, even if they are referenced multiple times (marked by their tag) */
+			std::vector<uint8_t> visited(words, 0);
+			std::vector<detail::ViewWord> pending{ root };
+			while (!pending.empty()) {
+				detail::ViewWord word = pending.back();
+				pending.pop_back();
+				size_t payload = detail::ViewState::Payload(word);
+
+				switch (detail::ViewState::Tag(word)) {
+				case detail::ViewTag::null:
+				case detail::ViewTag::boolean:
+				case detail::ViewTag::unum:
+				case detail::ViewTag::inum:
+					break;
+				case detail::ViewTag::unumSpill:
+				case detail::ViewTag::inumSpill:
+					if (payload >= words)
+						fail();
+					break;
+				case detail::ViewTag::real:
+					if (payload > words || detail::ViewRealWords > words - payload)
+						fail();
+					break;
+				case detail::ViewTag::str:
+					string(payload >> detail::ViewStrLengthBits, payload & detail::ViewStrLength);
+					break;
+				case detail::ViewTag::strSpill:
+					if (payload > words || 2 > words - payload)
+						fail();
+					string(size_t(state.words[payload]), size_t(state.words[payload + 1]));
+					break;
+				case detail::ViewTag::array: {
+					if (payload >= words)
+						fail();
+					if (visited[payload] & 0x01)
+						break;
+					visited[payload] |= 0x01;
+
+					/* validate the size and all values of the array */
+					size_t count = size_t(state.words[payload]);
+					if (count > words - payload - 1)
+						fail();
+					pending.insert(pending.end(), state.words.begin() + payload + 1, state.words.begin() + payload + 1 + count);
+					break;
+				}
+				case detail::ViewTag::object: {
+					if (payload > words || 2 > words - payload)
+						fail();
+					if (visited[payload] & 0x02)
+						break;
+					visited[payload] |= 0x02;
+
+					/* validate the size and all keys (which must be strings) and values of the object */
+					size_t count = size_t(state.words[payload]), table = size_t(state.words[payload + 1]);
+					if (count > (words - payload - 2) / 2)
+						fail();
+					for (size_t i = 0; i < count; ++i) {
+						detail::ViewTag tag = detail::ViewState::Tag(state.words[payload + 2 + 2 * i]);
+						if (tag != detail::ViewTag::str && tag != detail::ViewTag::strSpill)
+							fail();
+						pending.push_back(state.words[payload + 2 + 2 * i]);
+						pending.push_back(state.words[payload + 3 + 2 * i]);
+					}
+					if (table == 0)
+						break;
+
+					/* validate the hash-table, whose capacity must be a power of two, whose slots must reference
+					*	the key/value pairs, and which must contain an empty slot for the probing to terminate */
+					if (table >= words)
+						fail();
+					size_t mask = size_t(state.words[table]);
+					if ((mask & (mask + 1)) != 0 || mask >= words - table - 1)
+						fail();
+					bool empty = false;
+					for (size_t slot = 0; slot <= mask; ++slot) {
+						size_t pair = size_t(state.words[table + 1 + slot]);
+						if (pair > count)
+							fail();
+						empty = (empty || pair == 0);
+					}
+					if (!empty)
+						fail();
+					break;
+				}
+				default:
+					/* lazy containers reference the structural index of a lazy viewer, and can therefore never be part of an image */
+					fail();
+					break;
+				}
+			}
+		}
+		inline json::Viewer ReadImage(const std::shared_ptr<const void>& image, const uint8_t* data, size_t size, const std::wstring& name) {
+			/* validate the header and the sizes of the tape and string-pool */
+			detail::ViewImageHeader header{};
+			if (size < sizeof(header))
+				throw json::SnapshotException(L"Viewer-image [", name, L"] is truncated");
+			std::memcpy(&header, data, sizeof(header));
+			if (header.magic != detail::ViewImageMagic)
+				throw json::SnapshotException(L"File [", name, L"] is not a viewer-image");
+			if (header.version != detail::ViewImageVersion || header.layout != detail::ViewImageLayout)
+				throw json::SnapshotException(L"Viewer-image [", name, L"] is of an incompatible version or layout");
+			if (reinterpret_cast<uintptr_t>(data) % alignof(detail::ViewWord) != 0)
+				throw json::SnapshotException(L"Viewer-image [", name, L"] is not aligned to its words");
+			size_t unitSize = (header.utf8 != 0 ? sizeof(char8_t) : sizeof(wchar_t));
+			if (header.words > (size - sizeof(header)) / sizeof(detail::ViewWord) || header.units > (size - sizeof(header) - header.words * sizeof(detail::ViewWord)) / unitSize)
+				throw json::SnapshotException(L"Viewer-image [", name, L"] is truncated");
+
+			/* setup the state to reference the image directly and validate it once, as all accesses of the viewer are unchecked */
+			std::shared_ptr<detail::ViewState> state = std::make_shared<detail::ViewState>();
+			const uint8_t* pool = data + sizeof(header) + header.words * sizeof(detail::ViewWord);
+			state->words = std::span<const detail::ViewWord>{ reinterpret_cast<const detail::ViewWord*>(data + sizeof(header)), size_t(header.words) };
+			if (header.utf8 != 0) {
+				state->utf8 = true;
+				state->source = std::u8string_view{ reinterpret_cast<const char8_t*>(pool), size_t(header.units) };
+			}
+			else
+				state->chars = json::StrView{ reinterpret_cast<const wchar_t*>(pool), size_t(header.units) };
+			state->image = image;
+			detail::ValidateImage(*state.get(), header.root, name);
+			return detail::ViewAccess::Make(state, header.root);
+		}
+	}
+
+	/* reference to a byte-sink, which can be passed to json::Build/json::SerializeTo in place of a character-sink, to write the values
+	*	as binary viewer-image, which can be opened by json::OpenView/json::LoadView without parsing (the tape is assembled while
+	*	building, and the image is written out, once the root value has been completed)
+	*	Note: Must not outlive the sink as it stores a reference to it */
+	template <json::IsByteSink SinkType>
+	class ImageSink {
+	private:
+		SinkType* pSink = nullptr;
+
+	public:
+		constexpr ImageSink(SinkType& sink) : pSink{ &sink } {}
+
+	public:
+		constexpr SinkType& sink() {
+			return *pSink;
+		}
+	};
+
+	namespace detail {
+		template <class Type>
+		struct ImageSinkCheck : std::false_type {};
+		template <class SinkType>
+		struct ImageSinkCheck<json::ImageSink<SinkType>> : std::true_type {};
+
+		template <class SinkType>
+		struct BinaryOutput<json::ImageSink<SinkType>> : std::true_type {};
+	}
+
+	/* check if the type is a sink of viewer-images */
+	template <class Type>
+	concept IsImageSink = detail::ImageSinkCheck<std::remove_cvref_t<Type>>::value;
+
+	namespace detail {
+		template <class SinkType, char32_t CodeError>
+			requires json::IsImageSink<SinkType>
+		class Serializer<SinkType, CodeError> {
+		private:
+			std::remove_cvref_t<SinkType> pSink;
+			detail::ViewState pState;
+			std::vector<detail::ViewWord> pScratch;
+			std::vector<size_t> pOpen;
+
+			/* object-keys are stored once, as they are typically repeated across many objects */
+			std::unordered_map<json::Str, detail::ViewWord> pKeys;
+			json::Str pKey;
+
+		private:
+			constexpr detail::ViewWord fString(const auto& s) {
+				size_t offset = pState.strings.size();
+				str::TranscodeAllTo<CodeError>(pState.strings, s);
+				return pState.makeStr(offset, pState.strings.size() - offset);
+			}
+			constexpr void fValue(detail::ViewWord word) {
+				if (!pOpen.empty()) {
+					pScratch.push_back(word);
+					return;
+				}
+
+				/* write the image out, once the root value has been completed */
+				pState.sync();
+				detail::WriteImage(pSink.sink(), &pState, word);
+			}
+
+		public:
+			constexpr Serializer(const auto& sink, const std::wstring_view&) : pSink{ sink } {}
+
+		public:
+			constexpr std::remove_cvref_t<SinkType>& sink() {
+				return pSink;
+			}
+			constexpr void primitive(const auto& v) {
+				using VType = std::remove_cvref_t<decltype(v)>;
+
+				if constexpr (std::same_as<VType, json::Bool>)
+					fValue(detail::ViewState::Make(detail::ViewTag::boolean, v ? 1 : 0));
+				else if constexpr (std::same_as<VType, json::Null>)
+					fValue(detail::ViewState::Make(detail::ViewTag::null, 0));
+				else if constexpr (std::floating_point<VType>)
+					fValue(pState.makeReal(json::Real(v)));
+				else if constexpr (std::integral<VType>) {
+					if constexpr (std::is_signed_v<VType>)
+						fValue(pState.makeINum(json::INum(v)));
+					else
+						fValue(pState.makeUNum(json::UNum(v)));
+				}
+				else
+					fValue(fString(v));
+			}
+			constexpr void begin(bool) {
+				pOpen.push_back(pScratch.size());
+			}
+			constexpr void objectKey(const auto& s) {
+				pKey.clear();
+				str::TranscodeAllTo<CodeError>(pKey, s);
+				auto it = pKeys.find(pKey);
+				if (it == pKeys.end())
+					it = pKeys.insert({ pKey, fString(pKey) }).first;
+				pScratch.push_back(it->second);
+			}
+			constexpr void arrayValue() {}
+			constexpr void arrayValues(const auto& values) {
+				for (const auto& value : values)
+					primitive(value);
+			}
+			constexpr void end(bool obj) {
+				size_t base = pOpen.back();
+				pOpen.pop_back();
+
+				/* write the values out contiguously (objects are indexed, if large enough) and release the scratch-space */
+				detail::ViewWord word = (obj ? pState.makeObj(pScratch.data() + base, (pScratch.size() - base) / 2) : pState.makeArr(pScratch.data() + base, pScratch.size() - base));
+				pScratch.resize(base);
+				fValue(word);
+			}
+		};
+	}
+
+	/* write the tape and string-pool of the viewer as a binary image to the path, from which it can be loaded by json::LoadView
+	*	(the entire state of the viewer is written, even if the viewer only references a nested value of the state) */
+	inline void SaveView(const json::Viewer& viewer, const std::filesystem::path& path) {
+		std::ofstream file{ path, std::ios::out | std::ios::binary | std::ios::trunc };
+		detail::WriteImage(file, detail::ViewAccess::State(viewer).get(), detail::ViewAccess::Word(viewer));
+		file.close();
+		if (file.fail())
+			throw json::SnapshotException(L"Unable to write viewer-image [", path.wstring(), L"]");
+	}
+
+	/* write the binary image of the viewer, as written by json::SaveView, to the byte-container or binary output-stream
+	*	(used to pass viewers to json::OpenView, such as for inter-process communication or caches, which manage their own storage) */
+	template <json::IsByteSink SinkType>
+	void WriteView(const json::Viewer& viewer, SinkType& sink) {
+		detail::WriteImage(sink, detail::ViewAccess::State(viewer).get(), detail::ViewAccess::Word(viewer));
+	}
+
+	/* load a binary image written by json::SaveView by mapping it into memory and construct a viewer, which reads directly
+	*	from the mapping without parsing (the mapping is shared between all viewers and released once the last viewer is destroyed)
+	*	- the file must not be modified, while it is mapped
+	*	- the image is validated once, and malformed or truncated images are rejected by a json::SnapshotException
+	*	- images can only be loaded on systems with the same byte-order and sizes of wchar_t and json::Real */
+	inline json::Viewer LoadView(const std::filesystem::path& path) {
+		size_t size = 0;
+		std::shared_ptr<const void> image = detail::MapImage(path, size);
+		return detail::ReadImage(image, static_cast<const uint8_t*>(image.get()), size, path.wstring());
+	}
+
+	/* construct a viewer, which reads directly from the binary image in the caller-owned bytes without parsing or copying them
+	*	- the bytes must outlive the viewer and all viewers derived from it, and must not be modified
+	*	- the bytes must be aligned to 8 bytes (as by any allocation or mapping), as the words of the tape are read in place
+	*	- the image is validated once, and malformed or truncated images are rejected by a json::SnapshotException
+	*	- images can only be opened on systems with the same byte-order and sizes of wchar_t and json::Real */
+	inline json::Viewer OpenView(std::span<const uint8_t> image) {
+		return detail::ReadImage(nullptr, image.data(), image.size(), L"<memory>");
+	}
+}
@@ -301,6 +301,45 @@ namespace json {
 				return std::holds_alternative<json::Null>(*this);
 			}
 		}
+		template <size_t Count>
+		std::array<const json::Value*, Count> fExtract(const json::KeySet<Count>& keys, const json::Type* types) const {
+			static json::Value nullValue = json::Null();
+
+			if (!std::holds_alternative<detail::ObjPtr>(*this))
+				throw json::TypeException(L"json::Value is not a object");
+			const json::Obj& obj = *std::get<detail::ObjPtr>(*this);
+			std::array<const json::Value*, Count> out;
+			out.fill(&nullValue);
+
+			/* for small objects match the keys of all entries against the set (binary-searched without constructing any keys) */
+			if (obj.size() <= Count) {
+				for (const auto& [key, value] : obj) {
+					size_t id = keys.id(key);
+					if (id != json::UnknownKey && (types == nullptr || value.fConvertable(types[id])))
+						out[id] = &value;
+				}
+				return out;
+			}
+
+			/* for larger objects look up the keys of the set directly, by assigning them to a single key-buffer, which is reserved
+			*	once for the longest key of the set, as the map cannot be searched by views (only the first declaration of duplicate
+			*	keys, which is ordered first, is looked up) */
+			std::span<const detail::KeyEntry> entries = keys.entries();
+			size_t longest = 0;
+			for (const detail::KeyEntry& entry : entries)
+				longest = std::max(longest, entry.key.size());
+			json::Str key;
+			key.reserve(longest);
+			for (size_t i = 0; i < entries.size(); ++i) {
+				if (i > 0 && entries[i].key == entries[i - 1].key)
+					continue;
+				key.assign(entries[i].key);
+				auto it = obj.find(key);
+				if (it != obj.end() && (types == nullptr || it->second.fConvertable(types[entries[i].id])))
+					out[entries[i].id] = &it->second;
+			}
+			return out;
+		}
 
 	public:
 		constexpr bool isNull() const {
@@ -519,6 +558,17 @@ namespace json {
 			return true;
 		}
 
+		/* fetch the values of all keys of the set, indexed by their ids, by a single pass over small objects, or by direct lookups in larger objects
+		*	(keys, which are missing or whose values are not convertible to the optional type of their id, reference a null-value) */
+		template <size_t Count>
+		std::array<const json::Value*, Count> extract(const json::KeySet<Count>& keys) const {
+			return fExtract(keys, nullptr);
+		}
+		template <size_t Count>
+		std::array<const json::Value*, Count> extract(const json::KeySet<Count>& keys, const std::array<json::Type, Count>& types) const {
+			return fExtract(keys, types.data());
+		}
+
 		const json::Value& operator[](size_t i) const {
 			return this->at(i);
 		}
@@ -4,404 +4,1129 @@
 
 #include "json-common.h"
 #include "json-deserializer.h"
+#include "json-cbor.h"
+#include "json-msgpack.h"
 #include "json-value.h"
 
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
 namespace json {
-	class Viewer;
-	class ArrViewer;
-	class ObjViewer;
+	namespace detail {
+		struct ViewState;
+	}
+	template <class StateType>
+	class BasicViewer;
+	template <class StateType>
+	class BasicArrViewer;
+	template <class StateType>
+	class BasicObjViewer;
+
+	/* viewers, which share the ownership of the state, and keep it alive as long as any viewer of it exists */
+	using Viewer = json::BasicViewer<std::shared_ptr<detail::ViewState>>;
+	using ArrViewer = json::BasicArrViewer<std::shared_ptr<detail::ViewState>>;
+	using ObjViewer = json::BasicObjViewer<std::shared_ptr<detail::ViewState>>;
+
+	/* viewers, which only reference the state of an owning viewer, and are therefore trivially copyable without any
+	*	reference-counting (fetched via ref(), and must not be used after the last owning viewer of the state has been destroyed) */
+	using ViewerRef = json::BasicViewer<const detail::ViewState*>;
+	using ArrViewerRef = json::BasicArrViewer<const detail::ViewState*>;
+	using ObjViewerRef = json::BasicObjViewer<const detail::ViewState*>;
 
 	namespace detail {
-		struct StrViewObject {
-			size_t offset = 0;
-			size_t length = 0;
-		};
-		struct ArrViewObject {
-			size_t offset = 0;
-			size_t size = 0;
-		};
-		struct ObjViewObject {
-			size_t offset = 0;
-			size_t keysAndValues = 0;
+		/* words of the tape of the viewer, each consisting of a 4-bit tag and a 60-bit payload, whereby every value is
+		*	exactly one word, and larger payloads are spilled into separate words, which are referenced by the payload
+		*	(allows arrays and objects to be indexed directly, as their values are stored contiguously as single words) */
+		using ViewWord = uint64_t;
+		enum class ViewTag : uint8_t {
+			null,
+			boolean,
+			unum,
+			inum,
+			unumSpill,
+			inumSpill,
+			real,
+			str,
+			strSpill,
+			array,
+			object,
+			lazyArray,
+			lazyObject
 		};
-
-		using ViewEntry = std::variant<detail::StrViewObject, detail::ArrViewObject, detail::ObjViewObject, json::Null, json::UNum, json::INum, json::Real, json::Bool>;
-
+		static constexpr size_t ViewTagShift = 60;
+		static constexpr detail::ViewWord ViewPayload = (detail::ViewWord(1) << detail::ViewTagShift) - 1;
+
+		/* inline strings store the offset in the upper and the length in the lower bits of the payload */
+		static constexpr size_t ViewStrLengthBits = 24;
+		static constexpr detail::ViewWord ViewStrLength = (detail::ViewWord(1) << detail::ViewStrLengthBits) - 1;
+		static constexpr detail::ViewWord ViewStrOffset = (detail::ViewPayload >> detail::ViewStrLengthBits);
+
+		/* number of words required to spill a real */
+		static constexpr size_t ViewRealWords = (sizeof(json::Real) + sizeof(detail::ViewWord) - 1) / sizeof(detail::ViewWord);
+
+		/* number of keys from which on objects are indexed by a hash-table instead of being searched linearly */
+		static constexpr size_t ViewIndexThreshold = 16;
+
+		struct LazyView;
+		struct ColumnExtractor;
+
+		/* tape layout of the payloads (all indices reference the tape):
+		*	unum/inum: inline value (inum is sign-extended from 60 bits)
+		*	unumSpill/inumSpill: index of the value
+		*	real: index of the detail::ViewRealWords words of the value
+		*	str: inline offset and length in the string-pool
+		*	strSpill: index of the offset and length in the string-pool
+		*	array: index of [size, values...]
+		*	object: index of [size, table, key0, value0, key1, value1, ...]
+		*	table: index of [mask, slots...] (slots contain the index of the key/value pair + 1, or zero if empty)
+		*	lazyArray/lazyObject: index of the container in the structural index of the lazy viewer */
 		struct ViewState {
 		public:
-			std::vector<detail::ViewEntry> entries;
+			/* owned storage, into which the viewer is built */
+			std::vector<detail::ViewWord> tape;
 			json::Str strings;
 
+			/* utf-8 viewers reference the strings in the caller-owned source and only decode strings, which are not
+			*	contained verbatim, to escaped (their string-pool is the source followed by the escaped strings) */
+			std::u8string_view source;
+			std::u8string escaped;
+			bool utf8 = false;
+
+			/* tape and wide string-pool, from which the viewer is read (reference the owned storage or a loaded image) */
+			std::span<const detail::ViewWord> words;
+			json::StrView chars;
+
+			/* loaded image, which is referenced by the state and kept alive with it */
+			std::shared_ptr<const void> image;
+
+			/* lazy viewer, which owns this state and materializes the lazy containers */
+			detail::LazyView* lazy = nullptr;
+
+		private:
+			/* lazily transcoded strings of utf-8 viewers (guarded, as the state might be shared across threads,
+			*	but only for the wide strings, as the utf-8 strings are referenced in the source without any locking) */
+			mutable std::unordered_map<detail::ViewWord, json::Str> pWide;
+			mutable std::shared_mutex pMutex;
+
+		private:
+			template <class ChType>
+			static constexpr size_t fHash(std::basic_string_view<ChType> k) {
+				/* fnv-1a hash over the string-units */
+				size_t hash = size_t(14695981039346656037ull);
+				for (ChType c : k)
+					hash = (hash ^ size_t(std::make_unsigned_t<ChType>(c))) * size_t(1099511628211ull);
+				return hash;
+			}
+			template <class ChType, class KeyType>
+			static constexpr size_t fHashAs(std::basic_string_view<KeyType> k) {
+				/* hash the key as if it was encoded in the string-pool (transcodes one codepoint at a time without allocating) */
+				if constexpr (std::is_same_v<ChType, KeyType>)
+					return fHash(k);
+				else {
+					size_t hash = size_t(14695981039346656037ull);
+					while (!k.empty()) {
+						auto [out, len] = str::GetTranscode<ChType, str::err::DefChar>(k);
+						if (len == 0)
+							break;
+						k = k.substr(len);
+						for (ChType c : out)
+							hash = (hash ^ size_t(std::make_unsigned_t<ChType>(c))) * size_t(1099511628211ull);
+					}
+					return hash;
+				}
+			}
+			template <class ChType, class KeyType>
+			static constexpr bool fEqualAs(std::basic_string_view<ChType> s, std::basic_string_view<KeyType> k) {
+				/* compare the pooled string to the key in the encoding of the pool (transcodes one codepoint at a time without allocating) */
+				if constexpr (std::is_same_v<ChType, KeyType>)
+					return (s == k);
+				else {
+					while (!k.empty()) {
+						auto [out, len] = str::GetTranscode<ChType, str::err::DefChar>(k);
+						if (len == 0)
+							break;
+						k = k.substr(len);
+						if (s.size() < out.size())
+							return false;
+						for (size_t i = 0; i < out.size(); ++i) {
+							if (s[i] != out[i])
+								return false;
+						}
+						s = s.substr(out.size());
+					}
+					return s.empty();
+				}
+			}
+			constexpr std::pair<size_t, size_t> fLocate(detail::ViewWord word) const {
+				if (Tag(word) == detail::ViewTag::str)
+					return { Payload(word) >> detail::ViewStrLengthBits, Payload(word) & detail::ViewStrLength };
+				return { size_t(words[Payload(word)]), size_t(words[Payload(word) + 1]) };
+			}
+			template <class ChType>
+			constexpr std::basic_string_view<ChType> fView(detail::ViewWord word) const {
+				auto [offset, length] = fLocate(word);
+				if constexpr (std::is_same_v<ChType, wchar_t>)
+					return chars.substr(offset, length);
+				else if (offset < source.size())
+					return source.substr(offset, length);
+				else
+					return std::u8string_view{ escaped }.substr(offset - source.size(), length);
+			}
+			template <class ChType>
+			constexpr void fIndex(size_t obj, size_t table, size_t capacity) {
+				/* insert all keys in order, but skip duplicates to ensure the first occurrence is found */
+				for (size_t i = 0; i < size_t(tape[obj]); ++i) {
+					std::basic_string_view<ChType> k = fView<ChType>(tape[obj + 2 + 2 * i]);
+					size_t slot = fHash(k) & (capacity - 1);
+					while (tape[table + 1 + slot] != 0 && fView<ChType>(tape[obj + 2 * tape[table + 1 + slot]]) != k)
+						slot = (slot + 1) & (capacity - 1);
+					if (tape[table + 1 + slot] == 0)
+						tape[table + 1 + slot] = i + 1;
+				}
+			}
+			template <class ChType, class KeyType>
+			constexpr size_t fFind(size_t obj, std::basic_string_view<KeyType> k) const {
+				size_t count = size_t(words[obj]), table = size_t(words[obj + 1]);
+				if (table == 0) {
+					for (size_t i = 0; i < count; ++i) {
+						if (fEqualAs(fView<ChType>(words[obj + 2 + 2 * i]), k))
+							return obj + 3 + 2 * i;
+					}
+					return 0;
+				}
+
+				size_t mask = size_t(words[table]);
+				for (size_t slot = fHashAs<ChType>(k) & mask; words[table + 1 + slot] != 0; slot = (slot + 1) & mask) {
+					size_t index = obj + 2 * size_t(words[table + 1 + slot]);
+					if (fEqualAs(fView<ChType>(words[index]), k))
+						return index + 1;
+				}
+				return 0;
+			}
+
+		public:
+			static constexpr detail::ViewTag Tag(detail::ViewWord word) {
+				return detail::ViewTag(word >> detail::ViewTagShift);
+			}
+			static constexpr size_t Payload(detail::ViewWord word) {
+				return size_t(word & detail::ViewPayload);
+			}
+			static constexpr detail::ViewWord Make(detail::ViewTag tag, detail::ViewWord payload) {
+				return (detail::ViewWord(tag) << detail::ViewTagShift) | (payload & detail::ViewPayload);
+			}
+
+		public:
+			constexpr json::UNum unum(detail::ViewWord word) const {
+				if (Tag(word) == detail::ViewTag::unum)
+					return json::UNum(Payload(word));
+				return json::UNum(words[Payload(word)]);
+			}
+			constexpr json::INum inum(detail::ViewWord word) const {
+				if (Tag(word) == detail::ViewTag::inum)
+					return json::INum(word << (64 - detail::ViewTagShift)) >> (64 - detail::ViewTagShift);
+				return json::INum(words[Payload(word)]);
+			}
+			json::Real real(detail::ViewWord word) const {
+				json::Real value = 0;
+				std::memcpy(&value, words.data() + Payload(word), sizeof(json::Real));
+				return value;
+			}
+			json::StrView str(detail::ViewWord word) const {
+				if (!utf8)
+					return fView<wchar_t>(word);
+
+				/* lookup the already transcoded string with concurrent readers (map-entries are never relocated) */
+				{
+					std::shared_lock<std::shared_mutex> lock{ pMutex };
+					auto it = pWide.find(word);
+					if (it != pWide.end())
+						return it->second;
+				}
+
+				/* transcode the string outside of the lock and keep it for the lifetime of the state (the first insertion wins) */
+				json::Str wide;
+				str::TranscodeAllTo<str::err::DefChar>(wide, fView<char8_t>(word));
+				std::unique_lock<std::shared_mutex> lock{ pMutex };
+				return pWide.insert({ word, std::move(wide) }).first->second;
+			}
+			constexpr std::u8string_view u8(detail::ViewWord word) const {
+				return fView<char8_t>(word);
+			}
+			constexpr size_t length(detail::ViewWord word) const {
+				return fLocate(word).second;
+			}
+			constexpr size_t size(detail::ViewWord word) const {
+				return size_t(words[Payload(word)]);
+			}
+
+		public:
+			constexpr void sync() {
+				/* update the read-references to the owned storage (required once the viewer has been built) */
+				words = tape;
+				chars = strings;
+			}
+
 		public:
-			constexpr json::StrView str(size_t i) const {
-				const detail::StrViewObject& value = std::get<detail::StrViewObject>(entries[i]);
-				return json::StrView{ strings.data() + value.offset, value.length };
+			constexpr detail::ViewWord makeUNum(json::UNum value) {
+				if (value <= detail::ViewPayload)
+					return Make(detail::ViewTag::unum, value);
+				tape.push_back(value);
+				return Make(detail::ViewTag::unumSpill, tape.size() - 1);
+			}
+			constexpr detail::ViewWord makeINum(json::INum value) {
+				if (value >= -json::INum(detail::ViewPayload >> 1) - 1 && value <= json::INum(detail::ViewPayload >> 1))
+					return Make(detail::ViewTag::inum, detail::ViewWord(value));
+				tape.push_back(detail::ViewWord(value));
+				return Make(detail::ViewTag::inumSpill, tape.size() - 1);
+			}
+			detail::ViewWord makeReal(json::Real value) {
+				size_t offset = tape.size();
+				tape.resize(offset + detail::ViewRealWords, 0);
+				std::memcpy(tape.data() + offset, &value, sizeof(json::Real));
+				return Make(detail::ViewTag::real, offset);
+			}
+			constexpr detail::ViewWord makeStr(size_t offset, size_t length) {
+				if (offset <= detail::ViewStrOffset && length <= detail::ViewStrLength)
+					return Make(detail::ViewTag::str, (detail::ViewWord(offset) << detail::ViewStrLengthBits) | length);
+				tape.push_back(offset);
+				tape.push_back(length);
+				return Make(detail::ViewTag::strSpill, tape.size() - 2);
+			}
+			constexpr detail::ViewWord makeArr(const detail::ViewWord* values, size_t count) {
+				size_t offset = tape.size();
+				tape.push_back(count);
+				tape.insert(tape.end(), values, values + count);
+				return Make(detail::ViewTag::array, offset);
+			}
+			constexpr detail::ViewWord makeObj(const detail::ViewWord* keysAndValues, size_t count) {
+				size_t offset = tape.size();
+				tape.push_back(count);
+				tape.push_back(0);
+				tape.insert(tape.end(), keysAndValues, keysAndValues + 2 * count);
+				index(offset);
+				return Make(detail::ViewTag::object, offset);
+			}
+			constexpr void index(size_t obj) {
+				size_t count = size_t(tape[obj]);
+				if (count < detail::ViewIndexThreshold)
+					return;
+
+				/* allocate the table with a load-factor of at most one half */
+				size_t capacity = 1;
+				while (capacity < 2 * count)
+					capacity <<= 1;
+				size_t table = tape.size();
+				tape[obj + 1] = table;
+				tape.push_back(capacity - 1);
+				tape.resize(tape.size() + capacity, 0);
+
+				/* hash the keys in the encoding of the string-pool */
+				sync();
+				if (utf8)
+					fIndex<char8_t>(obj, table, capacity);
+				else
+					fIndex<wchar_t>(obj, table, capacity);
+			}
+			constexpr size_t find(size_t obj, json::StrView k) const {
+				/* lookup the index of the value of the first occurrence of the key (zero if not found, as no value can be at index zero) */
+				if (!utf8)
+					return fFind<wchar_t>(obj, k);
+				return fFind<char8_t>(obj, k);
+			}
+			constexpr size_t find(size_t obj, std::u8string_view k) const {
+				/* lookup the utf-8 key (compared directly against the strings of utf-8 viewers) */
+				if (!utf8)
+					return fFind<wchar_t>(obj, k);
+				return fFind<char8_t>(obj, k);
 			}
 		};
 
 		template <class StreamType, char32_t CodeError>
 		class ViewDeserializer {
 		private:
-			detail::Deserializer<StreamType, CodeError> pDeserializer;
+			/* utf-8 viewers can only reference the strings of contiguous utf-8 or messagepack sources */
+			static constexpr bool IsSource = std::is_same_v<std::remove_cvref_t<StreamType>, std::u8string_view> || json::IsMsgPackSource<StreamType>;
 
 		private:
-			constexpr detail::ObjViewObject fObject(detail::ViewState& state) {
-				detail::ObjViewObject out{};
+			detail::Deserializer<StreamType, CodeError>& pDeserializer;
+
+			/* stack of the words of all currently open containers, which is shared across the entire parse, as the
+			*	words of a container can only be written to the tape once the container has been closed */
+			std::vector<detail::ViewWord> pScratch;
+
+		private:
+			constexpr detail::ViewWord fObject(detail::ViewState& state) {
 				if (pDeserializer.checkIsEmpty(true))
-					return out;
-				std::vector<detail::ViewEntry> list;
+					return state.makeObj(nullptr, 0);
+				size_t base = pScratch.size();
 
 				/* read the value and check if the end has been reached */
 				do {
 					/* read the key */
-					detail::StrViewObject key = { state.strings.size(), 0 };
-					pDeserializer.readString(state.strings, true);
-					key.length = state.strings.size() - key.offset;
-					list.emplace_back(key);
+					pScratch.push_back(fString(state, true));
 
 					/* read the corresponding value */
-					list.emplace_back(fValue(state));
+					pScratch.push_back(fValue(state));
 				} while (!pDeserializer.closeElseSeparator(true));
 
-				/* update the actual array and write the state out */
-				out.offset = state.entries.size();
-				out.keysAndValues = list.size();
-				state.entries.insert(state.entries.end(), list.begin(), list.end());
+				/* write the keys and values out contiguously and index them, if the object is large enough, and release the scratch-space */
+				detail::ViewWord out = state.makeObj(pScratch.data() + base, (pScratch.size() - base) / 2);
+				pScratch.resize(base);
 				return out;
 			}
-			constexpr detail::ArrViewObject fArray(detail::ViewState& state) {
-				detail::ArrViewObject out{};
+			constexpr detail::ViewWord fArray(detail::ViewState& state) {
 				if (pDeserializer.checkIsEmpty(false))
-					return out;
-				std::vector<detail::ViewEntry> list;
+					return state.makeArr(nullptr, 0);
+				size_t base = pScratch.size();
 
 				/* read the value and check if the end has been reached */
 				do {
-					list.emplace_back(fValue(state));
+					pScratch.push_back(fValue(state));
 				} while (!pDeserializer.closeElseSeparator(false));
 
-				/* update the actual array and write the state out */
-				out.offset = state.entries.size();
-				out.size = list.size();
-				state.entries.insert(state.entries.end(), list.begin(), list.end());
+				/* write the values out contiguously and release the scratch-space */
+				detail::ViewWord out = state.makeArr(pScratch.data() + base, pScratch.size() - base);
+				pScratch.resize(base);
 				return out;
 			}
-			constexpr detail::ViewEntry fValue(detail::ViewState& state) {
-				switch (pDeserializer.peekOrOpenNext()) {
-				case json::Type::string: {
-					size_t start = state.strings.size();
-					pDeserializer.readString(state.strings, false);
-					return detail::StrViewObject{ start, state.strings.size() - start };
+			constexpr detail::ViewWord fString(detail::ViewState& state, bool key) {
+				/* reference the string in the source, if it is contained verbatim, and otherwise decode it behind the source */
+				if constexpr (IsSource) {
+					if (state.utf8) {
+						size_t offset = 0, length = 0;
+						if (!pDeserializer.readVerbatim(state.source, state.escaped, offset, length, key))
+							offset += state.source.size();
+						return state.makeStr(offset, length);
+					}
 				}
+
+				size_t offset = state.strings.size();
+				pDeserializer.readString(state.strings, key);
+				return state.makeStr(offset, state.strings.size() - offset);
+			}
+			constexpr detail::ViewWord fValue(detail::ViewState& state) {
+				switch (pDeserializer.peekOrOpenNext()) {
+				case json::Type::string:
+					return fString(state, false);
 				case json::Type::object:
 					return fObject(state);
 				case json::Type::array:
 					return fArray(state);
 				case json::Type::boolean:
-					return pDeserializer.readBoolean();
+					return detail::ViewState::Make(detail::ViewTag::boolean, pDeserializer.readBoolean() ? 1 : 0);
 				case json::Type::inumber:
 				case json::Type::unumber:
 				case json::Type::real: {
 					detail::NumberValue value = pDeserializer.readNumber();
 					if (std::holds_alternative<json::INum>(value))
-						return std::get<json::INum>(value);
+						return state.makeINum(std::get<json::INum>(value));
 					else if (std::holds_alternative<json::UNum>(value))
-						return std::get<json::UNum>(value);
-					return std::get<json::Real>(value);
+						return state.makeUNum(std::get<json::UNum>(value));
+					return state.makeReal(std::get<json::Real>(value));
 				}
 				case json::Type::null:
 				default:
-					return pDeserializer.readNull();
+					pDeserializer.readNull();
+					return detail::ViewState::Make(detail::ViewTag::null, 0);
 				}
 			}
 
 		public:
-			constexpr ViewDeserializer(auto&& stream, detail::ViewState& out) : pDeserializer{ std::forward<StreamType>(stream) } {
-				out.entries.emplace_back();
-				out.entries[0] = fValue(out);
-				pDeserializer.checkDone();
+			constexpr ViewDeserializer(detail::Deserializer<StreamType, CodeError>& deserializer) : pDeserializer{ deserializer } {}
+
+		public:
+			constexpr detail::ViewWord read(detail::ViewState& out) {
+				return fValue(out);
+			}
+			constexpr detail::ViewWord readOpened(detail::ViewState& out, bool object) {
+				/* read the remainder of an object/array, which has already been opened by the deserializer */
+				if (object)
+					return fObject(out);
+				return fArray(out);
+			}
+		};
+
+		/* write a json::Value into the tape of a state (identical strings are only written once to the string-pool) */
+		class ValueFreezer {
+		private:
+			std::vector<detail::ViewWord> pScratch;
+			std::unordered_map<json::StrView, detail::ViewWord> pStrings;
+
+		private:
+			detail::ViewWord fString(detail::ViewState& state, json::StrView s) {
+				auto [it, inserted] = pStrings.insert({ s, 0 });
+				if (inserted) {
+					it->second = state.makeStr(state.strings.size(), s.size());
+					state.strings.append(s);
+				}
+				return it->second;
+			}
+			detail::ViewWord fValue(detail::ViewState& state, const json::Value& value) {
+				switch (value.type()) {
+				case json::Type::boolean:
+					return detail::ViewState::Make(detail::ViewTag::boolean, value.boolean() ? 1 : 0);
+				case json::Type::unumber:
+					return state.makeUNum(value.unum());
+				case json::Type::inumber:
+					return state.makeINum(value.inum());
+				case json::Type::real:
+					return state.makeReal(value.real());
+				case json::Type::string:
+					return fString(state, value.str());
+				case json::Type::array: {
+					size_t base = pScratch.size();
+					for (const json::Value& entry : value.arr())
+						pScratch.push_back(fValue(state, entry));
+
+					/* write the values out contiguously and release the scratch-space */
+					detail::ViewWord out = state.makeArr(pScratch.data() + base, pScratch.size() - base);
+					pScratch.resize(base);
+					return out;
+				}
+				case json::Type::object: {
+					size_t base = pScratch.size();
+					for (const auto& [key, entry] : value.obj()) {
+						pScratch.push_back(fString(state, key));
+						pScratch.push_back(fValue(state, entry));
+					}
+
+					/* write the keys and values out contiguously and index them, if the object is large enough, and release the scratch-space */
+					detail::ViewWord out = state.makeObj(pScratch.data() + base, (pScratch.size() - base) / 2);
+					pScratch.resize(base);
+					return out;
+				}
+				case json::Type::null:
+				default:
+					return detail::ViewState::Make(detail::ViewTag::null, 0);
+				}
+			}
+
+		public:
+			detail::ViewWord read(detail::ViewState& out, const json::Value& value) {
+				return fValue(out, value);
+			}
+		};
+
+		/* offsets of the opening and closing brackets of a container and the number of containers nested within it */
+		struct LazySpan {
+			size_t begin = 0;
+			size_t end = 0;
+			size_t nested = 0;
+		};
+
+		/* materialized container of a lazy viewer, which is published through the atomic pointer, once its state and root have
+		*	been written, such that materialized containers can be read without locking (owned is only written under the lock) */
+		struct LazySlot {
+			std::unique_ptr<detail::ViewState> owned;
+			std::atomic<detail::ViewState*> state = nullptr;
+			detail::ViewWord root = 0;
+		};
+
+		/* structural index of a contiguous utf-8 source, which owns the states of all containers,
+		*	which have been materialized so far (indexed by their position in the structural index) */
+		struct LazyView {
+		public:
+			std::u8string_view source;
+			std::vector<detail::LazySpan> spans;
+			std::unique_ptr<detail::LazySlot[]> slots;
+			detail::ViewState base;
+			void (*materialize)(detail::LazyView&, size_t) = nullptr;
+
+		private:
+			std::mutex pMutex;
+
+		public:
+			LazyView(std::u8string_view s) : source{ s } {
+				std::vector<size_t> open;
+				bool string = false, escape = false;
+
+				/* only track the strings and brackets (structural characters are always ascii, and can therefore not occur within encoded codepoints) */
+				for (size_t i = 0; i < source.size(); ++i) {
+					char8_t c = source[i];
+					if (string) {
+						if (escape)
+							escape = false;
+						else if (c == u8'\\')
+							escape = true;
+						else if (c == u8'\"')
+							string = false;
+						continue;
+					}
+
+					if (c == u8'\"')
+						string = true;
+					else if (c == u8'[' || c == u8'{') {
+						open.push_back(spans.size());
+						spans.push_back(detail::LazySpan{ i, 0, 0 });
+					}
+					else if (c == u8']' || c == u8'}') {
+						if (open.empty() || source[spans[open.back()].begin] != (c == u8']' ? u8'[' : u8'{'))
+							throw json::DeserializeException(L"Unbalanced brackets encountered at offset ", i);
+						spans[open.back()].end = i;
+						spans[open.back()].nested = spans.size() - open.back() - 1;
+						open.pop_back();
+					}
+				}
+				if (string || !open.empty())
+					throw json::DeserializeException(L"Unexpected <EOF> encountered at offset ", source.size());
+
+				slots = std::make_unique<detail::LazySlot[]>(spans.size());
+				base.source = source;
+				base.utf8 = true;
+				base.lazy = this;
+			}
+
+		public:
+			std::pair<detail::ViewState*, detail::ViewWord> resolve(size_t index) {
+				detail::LazySlot& slot = slots[index];
+
+				/* check if the container has already been materialized and published, in which case it can be read without locking */
+				if (detail::ViewState* state = slot.state.load(std::memory_order_acquire); state != nullptr)
+					return { state, slot.root };
+
+				/* materialize the container once (guarded, as the viewer might be shared across threads) and publish it */
+				std::unique_lock<std::mutex> lock{ pMutex };
+				if (slot.owned.get() == nullptr) {
+					materialize(*this, index);
+					slot.state.store(slot.owned.get(), std::memory_order_release);
+				}
+				return { slot.owned.get(), slot.root };
+			}
+		};
+
+		template <char32_t CodeError>
+		class LazyDeserializer {
+		private:
+			using Deserializer = detail::Deserializer<std::u8string_view, CodeError>;
+
+		private:
+			detail::LazyView& pLazy;
+			detail::ViewState& pState;
+			std::optional<Deserializer> pDeserializer;
+			std::vector<detail::ViewWord> pList;
+			size_t pNext = 0;
+
+		private:
+			void fOpen(size_t offset) {
+				/* start a new deserializer at the offset (positions of errors are reported as offsets) */
+				pDeserializer.emplace(pLazy.source.substr(offset));
+				pDeserializer->setOrigin(json::Bookmark{ offset, offset });
+			}
+			detail::ViewWord fString(bool key) {
+				size_t offset = 0, length = 0;
+				if (!pDeserializer->readVerbatim(pLazy.source, pState.escaped, offset, length, key))
+					offset += pLazy.source.size();
+				return pState.makeStr(offset, length);
+			}
+			detail::ViewWord fValue() {
+				switch (pDeserializer->peekOrOpenNext()) {
+				case json::Type::string:
+					return fString(false);
+				case json::Type::object:
+				case json::Type::array: {
+					/* reference the nested container lazily and continue behind its closing bracket */
+					size_t index = pNext;
+					pNext += 1 + pLazy.spans[index].nested;
+					detail::ViewTag tag = (pLazy.source[pLazy.spans[index].begin] == u8'{' ? detail::ViewTag::lazyObject : detail::ViewTag::lazyArray);
+					fOpen(pLazy.spans[index].end + 1);
+					return detail::ViewState::Make(tag, index);
+				}
+				case json::Type::boolean:
+					return detail::ViewState::Make(detail::ViewTag::boolean, pDeserializer->readBoolean() ? 1 : 0);
+				case json::Type::inumber:
+				case json::Type::unumber:
+				case json::Type::real: {
+					detail::NumberValue value = pDeserializer->readNumber();
+					if (std::holds_alternative<json::INum>(value))
+						return pState.makeINum(std::get<json::INum>(value));
+					else if (std::holds_alternative<json::UNum>(value))
+						return pState.makeUNum(std::get<json::UNum>(value));
+					return pState.makeReal(std::get<json::Real>(value));
+				}
+				case json::Type::null:
+				default:
+					pDeserializer->readNull();
+					return detail::ViewState::Make(detail::ViewTag::null, 0);
+				}
+			}
+
+		public:
+			LazyDeserializer(detail::LazyView& lazy, detail::ViewState& state) : pLazy{ lazy }, pState{ state } {}
+
+		public:
+			detail::ViewWord read(size_t index) {
+				/* open the container and read its direct values (nested containers are skipped by the structural index) */
+				fOpen(pLazy.spans[index].begin);
+				pNext = index + 1;
+				bool object = (pDeserializer->peekOrOpenNext() == json::Type::object);
+				if (pDeserializer->checkIsEmpty(object))
+					return (object ? pState.makeObj(nullptr, 0) : pState.makeArr(nullptr, 0));
+
+				do {
+					if (object)
+						pList.push_back(fString(true));
+					pList.push_back(fValue());
+				} while (!pDeserializer->closeElseSeparator(object));
+				if (object)
+					return pState.makeObj(pList.data(), pList.size() / 2);
+				return pState.makeArr(pList.data(), pList.size());
 			}
 		};
 
+		template <char32_t CodeError>
+		void LazyMaterialize(detail::LazyView& lazy, size_t index) {
+			std::unique_ptr<detail::ViewState> state = std::make_unique<detail::ViewState>();
+			state->source = lazy.source;
+			state->utf8 = true;
+			state->lazy = &lazy;
+
+			lazy.slots[index].root = detail::LazyDeserializer<CodeError>{ lazy, *state.get() }.read(index);
+			state->sync();
+			lazy.slots[index].owned = std::move(state);
+		}
+
 		struct ViewAccess {
-			static json::Viewer Make(const std::shared_ptr<detail::ViewState>& state, size_t index);
+			static json::Viewer Make(const std::shared_ptr<detail::ViewState>& state, detail::ViewWord word);
+			static const std::shared_ptr<detail::ViewState>& State(const json::Viewer& viewer);
+			static detail::ViewWord Word(const json::Viewer& viewer);
+		};
+
+		template <class StateType>
+		constexpr const detail::ViewState* ViewPointer(const StateType& state) {
+			if constexpr (std::is_pointer_v<StateType>)
+				return state;
+			else
+				return state.get();
+		}
+
+		/* materialize the value of the word by walking the tape directly (containers are reserved with their exact
+		*	sizes and strings are copied, while only strings of utf-8 viewers need to be transcoded) */
+		struct ViewMaterializer {
+		private:
+			static json::Str fStr(const detail::ViewState& state, detail::ViewWord word) {
+				if (!state.utf8)
+					return json::Str{ state.str(word) };
+
+				/* transcode the utf-8 string directly, instead of caching it in the state */
+				json::Str out;
+				str::TranscodeAllTo<str::err::DefChar>(out, state.u8(word));
+				return out;
+			}
+
+		public:
+			static json::Value Make(const detail::ViewState* state, detail::ViewWord word) {
+				switch (detail::ViewState::Tag(word)) {
+				case detail::ViewTag::boolean:
+					return json::Value{ json::Bool(detail::ViewState::Payload(word) != 0) };
+				case detail::ViewTag::unum:
+				case detail::ViewTag::unumSpill:
+					return json::Value{ state->unum(word) };
+				case detail::ViewTag::inum:
+				case detail::ViewTag::inumSpill:
+					return json::Value{ state->inum(word) };
+				case detail::ViewTag::real:
+					return json::Value{ state->real(word) };
+				case detail::ViewTag::str:
+				case detail::ViewTag::strSpill:
+					return json::Value{ fStr(*state, word) };
+				case detail::ViewTag::array: {
+					size_t offset = detail::ViewState::Payload(word), count = state->size(word);
+					json::Arr arr;
+					arr.reserve(count);
+					for (size_t i = 0; i < count; ++i)
+						arr.push_back(Make(state, state->words[offset + 1 + i]));
+					return json::Value{ std::move(arr) };
+				}
+				case detail::ViewTag::object: {
+					/* for objects with multiple identical keys, the last occurring value will be used */
+					size_t offset = detail::ViewState::Payload(word), count = state->size(word);
+					json::Obj obj;
+					obj.reserve(count);
+					for (size_t i = 0; i < count; ++i)
+						obj.insert_or_assign(fStr(*state, state->words[offset + 2 + 2 * i]), Make(state, state->words[offset + 3 + 2 * i]));
+					return json::Value{ std::move(obj) };
+				}
+				case detail::ViewTag::lazyArray:
+				case detail::ViewTag::lazyObject: {
+					auto [resolved, root] = state->lazy->resolve(detail::ViewState::Payload(word));
+					return Make(resolved, root);
+				}
+				case detail::ViewTag::null:
+				default:
+					return json::Value{};
+				}
+			}
 		};
 	}
 
 	/* [json::IsJson] json-view of type [value], which can be used to read the current value
-	*	Note: This is a light-weight object, which can just be copied around, as it keeps a reference to the actual state */
-	class Viewer : private detail::ViewEntry {
+	*	Note: This is a light-weight object, which can just be copied around, as it keeps a reference to the actual state
+	*	(shared for json::Viewer, and a plain pointer for json::ViewerRef) */
+	template <class StateType>
+	class BasicViewer {
+		template <class> friend class json::BasicViewer;
+		template <class> friend class json::BasicArrViewer;
+		template <class> friend class json::BasicObjViewer;
 		friend struct detail::ViewAccess;
 	private:
-		std::shared_ptr<detail::ViewState> pState;
+		StateType pState{};
+		detail::ViewWord pWord = 0;
 
 	public:
-		constexpr Viewer() : detail::ViewEntry{ json::Null() } {}
-		constexpr Viewer(json::Viewer&&) = default;
-		constexpr Viewer(const json::Viewer&) = default;
-		constexpr json::Viewer& operator=(json::Viewer&&) = default;
-		constexpr json::Viewer& operator=(const json::Viewer&) = default;
+		constexpr BasicViewer() = default;
+		constexpr BasicViewer(json::BasicViewer<StateType>&&) = default;
+		constexpr BasicViewer(const json::BasicViewer<StateType>&) = default;
+		constexpr json::BasicViewer<StateType>& operator=(json::BasicViewer<StateType>&&) = default;
+		constexpr json::BasicViewer<StateType>& operator=(const json::BasicViewer<StateType>&) = default;
 
 	private:
-		Viewer(const std::shared_ptr<detail::ViewState>& state, size_t index) : pState{ state }, detail::ViewEntry{ state->entries[index] } {}
+		BasicViewer(const StateType& state, detail::ViewWord word) : pState{ state }, pWord{ word } {}
 
 	private:
-		static constexpr bool fConvertible(json::Type t, const detail::ViewEntry& value) {
+		constexpr detail::ViewTag fTag() const {
+			return detail::ViewState::Tag(pWord);
+		}
+		constexpr size_t fPayload() const {
+			return detail::ViewState::Payload(pWord);
+		}
+		constexpr bool fConvertible(json::Type t, detail::ViewWord word) const {
+			detail::ViewTag tag = detail::ViewState::Tag(word);
 			switch (t) {
 			case json::Type::array:
-				return std::holds_alternative<detail::ArrViewObject>(value);
+				return (tag == detail::ViewTag::array || tag == detail::ViewTag::lazyArray);
 			case json::Type::object:
-				return std::holds_alternative<detail::ObjViewObject>(value);
+				return (tag == detail::ViewTag::object || tag == detail::ViewTag::lazyObject);
 			case json::Type::string:
-				return std::holds_alternative<detail::StrViewObject>(value);
+				return (tag == detail::ViewTag::str || tag == detail::ViewTag::strSpill);
 			case json::Type::unumber:
-				if (std::holds_alternative<json::UNum>(value))
+				if (tag == detail::ViewTag::unum || tag == detail::ViewTag::unumSpill)
 					return true;
-				if (std::holds_alternative<json::INum>(value) && std::get<json::INum>(value) >= 0)
+				if ((tag == detail::ViewTag::inum || tag == detail::ViewTag::inumSpill) && pState->inum(word) >= 0)
 					return true;
 				return false;
 			case json::Type::inumber:
-				if (std::holds_alternative<json::INum>(value))
+				if (tag == detail::ViewTag::inum || tag == detail::ViewTag::inumSpill)
 					return true;
-				if (std::holds_alternative<json::UNum>(value))
+				if (tag == detail::ViewTag::unum || tag == detail::ViewTag::unumSpill)
 					return true;
 				return false;
 			case json::Type::real:
-				if (std::holds_alternative<json::Real>(value))
+				if (tag == detail::ViewTag::real)
 					return true;
-				if (std::holds_alternative<json::INum>(value))
+				if (tag == detail::ViewTag::inum || tag == detail::ViewTag::inumSpill)
 					return true;
-				if (std::holds_alternative<json::UNum>(value))
+				if (tag == detail::ViewTag::unum || tag == detail::ViewTag::unumSpill)
 					return true;
 				return false;
 			case json::Type::boolean:
-				return std::holds_alternative<json::Bool>(value);
+				return (tag == detail::ViewTag::boolean);
 			default:
-				return std::holds_alternative<json::Null>(value);
+				return (tag == detail::ViewTag::null);
 			}
 		}
+		constexpr bool fLazy() const {
+			return (fTag() == detail::ViewTag::lazyArray || fTag() == detail::ViewTag::lazyObject);
+		}
+		json::BasicViewer<StateType> fResolve() const {
+			/* materialize the lazy container and reference its state (owned by the lazy viewer, which is kept alive by the shared state) */
+			auto [state, word] = pState->lazy->resolve(fPayload());
+			if constexpr (std::is_pointer_v<StateType>)
+				return json::BasicViewer<StateType>{ state, word };
+			else
+				return json::BasicViewer<StateType>{ StateType{ pState, state }, word };
+		}
+		json::BasicViewer<StateType> fAt(const auto& k) const {
+			static json::BasicViewer<StateType> nullValue{};
+
+			if (!isObj())
+				throw json::TypeException(L"json::Viewer is not a object");
+			if (fLazy())
+				return fResolve().fAt(k);
+
+			size_t index = pState->find(fPayload(), k);
+			if (index == 0)
+				return nullValue;
+			return json::BasicViewer<StateType>{ pState, pState->words[index] };
+		}
+		constexpr bool fContains(const auto& k, std::optional<json::Type> t) const {
+			if (!isObj())
+				return false;
+			if (fLazy())
+				return fResolve().fContains(k, t);
+
+			size_t index = pState->find(fPayload(), k);
+			return (index != 0 && (!t.has_value() || fConvertible(*t, pState->words[index])));
+		}
+		template <size_t Count>
+		size_t fKeyId(const json::KeySet<Count>& keys, detail::ViewWord word) const {
+			if (!pState->utf8)
+				return keys.id(pState->str(word));
+
+			/* match the utf-8 key directly, instead of transcoding it */
+			detail::KeyMatcher matcher{ keys.entries() };
+			std::u8string_view key = pState->u8(word);
+			while (!key.empty()) {
+				auto [cp, len] = str::GetCodepoint<str::err::DefChar>(key);
+				matcher.next(cp);
+				key = key.substr(len);
+			}
+			return matcher.id();
+		}
+		template <size_t Count>
+		std::array<json::BasicViewer<StateType>, Count> fExtract(const json::KeySet<Count>& keys, const json::Type* types) const {
+			if (!isObj())
+				throw json::TypeException(L"json::Viewer is not a object");
+			if (fLazy())
+				return fResolve().fExtract(keys, types);
+			std::array<json::BasicViewer<StateType>, Count> out;
+			std::array<bool, Count> found{};
+			size_t offset = fPayload(), count = pState->size(pWord);
+
+			/* walk the entries once and keep the first occurrence of every key */
+			for (size_t i = 0; i < count; ++i) {
+				size_t id = fKeyId(keys, pState->words[offset + 2 + 2 * i]);
+				if (id == json::UnknownKey || found[id])
+					continue;
+				found[id] = true;
+				detail::ViewWord word = pState->words[offset + 3 + 2 * i];
+				if (types == nullptr || fConvertible(types[id], word))
+					out[id] = json::BasicViewer<StateType>{ pState, word };
+			}
+			return out;
+		}
 
 	public:
 		constexpr bool isNull() const {
-			return std::holds_alternative<json::Null>(*this);
+			return (fTag() == detail::ViewTag::null);
 		}
 		constexpr bool isBoolean() const {
-			return std::holds_alternative<json::Bool>(*this);
+			return (fTag() == detail::ViewTag::boolean);
 		}
 		constexpr bool isStr() const {
-			return std::holds_alternative<detail::StrViewObject>(*this);
+			return (fTag() == detail::ViewTag::str || fTag() == detail::ViewTag::strSpill);
 		}
 		constexpr bool isUNum() const {
-			if (std::holds_alternative<json::UNum>(*this))
-				return true;
-			return (std::holds_alternative<json::INum>(*this) && std::get<json::INum>(*this) >= 0);
+			return fConvertible(json::Type::unumber, pWord);
 		}
 		constexpr bool isINum() const {
-			return std::holds_alternative<json::UNum>(*this) || std::holds_alternative<json::INum>(*this);
+			return fConvertible(json::Type::inumber, pWord);
 		}
 		constexpr bool isReal() const {
-			return std::holds_alternative<json::UNum>(*this) || std::holds_alternative<json::INum>(*this) || std::holds_alternative<json::Real>(*this);
+			return fConvertible(json::Type::real, pWord);
 		}
 		constexpr bool isObj() const {
-			return std::holds_alternative<detail::ObjViewObject>(*this);
+			return (fTag() == detail::ViewTag::object || fTag() == detail::ViewTag::lazyObject);
 		}
 		constexpr bool isArr() const {
-			return std::holds_alternative<detail::ArrViewObject>(*this);
+			return (fTag() == detail::ViewTag::array || fTag() == detail::ViewTag::lazyArray);
 		}
 		constexpr bool is(json::Type t) const {
-			return fConvertible(t, *this);
+			return fConvertible(t, pWord);
 		}
 		constexpr json::Type type() const {
-			if (std::holds_alternative<json::Bool>(*this))
+			switch (fTag()) {
+			case detail::ViewTag::boolean:
 				return json::Type::boolean;
-			if (std::holds_alternative<detail::StrViewObject>(*this))
+			case detail::ViewTag::str:
+			case detail::ViewTag::strSpill:
 				return json::Type::string;
-			if (std::holds_alternative<detail::ObjViewObject>(*this))
+			case detail::ViewTag::object:
+			case detail::ViewTag::lazyObject:
 				return json::Type::object;
-			if (std::holds_alternative<detail::ArrViewObject>(*this))
+			case detail::ViewTag::array:
+			case detail::ViewTag::lazyArray:
 				return json::Type::array;
-			if (std::holds_alternative<json::Real>(*this))
+			case detail::ViewTag::real:
 				return json::Type::real;
-			if (std::holds_alternative<json::UNum>(*this))
+			case detail::ViewTag::unum:
+			case detail::ViewTag::unumSpill:
 				return json::Type::unumber;
-			if (std::holds_alternative<json::INum>(*this))
+			case detail::ViewTag::inum:
+			case detail::ViewTag::inumSpill:
 				return json::Type::inumber;
-			return json::Type::null;
+			case detail::ViewTag::null:
+			default:
+				return json::Type::null;
+			}
 		}
 
 	public:
 		constexpr json::Bool boolean() const {
-			if (!std::holds_alternative<json::Bool>(*this))
+			if (fTag() != detail::ViewTag::boolean)
 				throw json::TypeException(L"json::Viewer is not a bool");
-			return std::get<json::Bool>(*this);
+			return (fPayload() != 0);
 		}
-		constexpr json::StrView str() const {
-			if (!std::holds_alternative<detail::StrViewObject>(*this))
+		json::StrView str() const {
+			if (!isStr())
 				throw json::TypeException(L"json::Viewer is not a string");
+			return pState->str(pWord);
+		}
 
-			detail::StrViewObject str = std::get<detail::StrViewObject>(*this);
-			return json::StrView{ pState->strings.data() + str.offset, str.length };
+		/* fetch the utf-8 string of a viewer created by json::ViewUtf8 (references the source, unless it has been decoded) */
+		constexpr std::u8string_view u8str() const {
+			if (!isStr())
+				throw json::TypeException(L"json::Viewer is not a string");
+			if (!pState->utf8)
+				throw json::TypeException(L"json::Viewer is not utf-8 encoded");
+			return pState->u8(pWord);
 		}
 		constexpr json::UNum unum() const {
-			if (std::holds_alternative<json::INum>(*this) && std::get<json::INum>(*this) >= 0)
-				return json::UNum(std::get<json::INum>(*this));
-			if (std::holds_alternative<json::Real>(*this) && std::get<json::Real>(*this) >= 0)
-				return json::UNum(std::get<json::Real>(*this));
+			if ((fTag() == detail::ViewTag::inum || fTag() == detail::ViewTag::inumSpill) && pState->inum(pWord) >= 0)
+				return json::UNum(pState->inum(pWord));
+			if (fTag() == detail::ViewTag::real && pState->real(pWord) >= 0)
+				return json::UNum(pState->real(pWord));
 
-			if (!std::holds_alternative<json::UNum>(*this))
+			if (fTag() != detail::ViewTag::unum && fTag() != detail::ViewTag::unumSpill)
 				throw json::TypeException(L"json::Viewer is not an unsigned-number");
-			return std::get<json::UNum>(*this);
+			return pState->unum(pWord);
 		}
 		constexpr json::INum inum() const {
-			if (std::holds_alternative<json::UNum>(*this))
-				return json::INum(std::get<json::UNum>(*this));
-			if (std::holds_alternative<json::Real>(*this))
-				return json::INum(std::get<json::Real>(*this));
+			if (fTag() == detail::ViewTag::unum || fTag() == detail::ViewTag::unumSpill)
+				return json::INum(pState->unum(pWord));
+			if (fTag() == detail::ViewTag::real)
+				return json::INum(pState->real(pWord));
 
-			if (!std::holds_alternative<json::INum>(*this))
+			if (fTag() != detail::ViewTag::inum && fTag() != detail::ViewTag::inumSpill)
 				throw json::TypeException(L"json::Viewer is not a signed-number");
-			return std::get<json::INum>(*this);
+			return pState->inum(pWord);
 		}
 		constexpr json::Real real() const {
-			if (std::holds_alternative<json::UNum>(*this))
-				return json::Real(std::get<json::UNum>(*this));
-			if (std::holds_alternative<json::INum>(*this))
-				return json::Real(std::get<json::INum>(*this));
+			if (fTag() == detail::ViewTag::unum || fTag() == detail::ViewTag::unumSpill)
+				return json::Real(pState->unum(pWord));
+			if (fTag() == detail::ViewTag::inum || fTag() == detail::ViewTag::inumSpill)
+				return json::Real(pState->inum(pWord));
 
-			if (!std::holds_alternative<json::Real>(*this))
+			if (fTag() != detail::ViewTag::real)
 				throw json::TypeException(L"json::Viewer is not a real");
-			return std::get<json::Real>(*this);
+			return pState->real(pWord);
+		}
+		json::BasicArrViewer<StateType> arr() const;
+		json::BasicObjViewer<StateType> obj() const;
+
+		/* construct a non-owning viewer of this value, which can be copied without modifying the shared reference-count */
+		constexpr json::ViewerRef ref() const {
+			return json::ViewerRef{ detail::ViewPointer(pState), pWord };
 		}
-		json::ArrViewer arr() const;
-		json::ObjViewer obj() const;
 
 	public:
-		/* construct a json::Value from this object */
+		/* construct a json::Value from this object (walks the tape directly, instead of converting it through the generic viewer-interface) */
 		constexpr json::Value value() const;
 
 	public:
-		/* operations shared between array/string/objects (depends on type, zero for non-container types) */
+		/* operations shared between array/string/objects (depends on type, zero for non-container types, strings of utf-8 viewers count bytes) */
 		constexpr size_t size() const {
-			if (std::holds_alternative<detail::ArrViewObject>(*this))
-				return std::get<detail::ArrViewObject>(*this).size;
-			if (std::holds_alternative<detail::ObjViewObject>(*this))
-				return std::get<detail::ObjViewObject>(*this).keysAndValues / 2;
-			if (std::holds_alternative<detail::StrViewObject>(*this))
-				return std::get<detail::StrViewObject>(*this).length;
+			if (fLazy())
+				return fResolve().size();
+			if (isArr() || isObj())
+				return pState->size(pWord);
+			if (isStr())
+				return pState->length(pWord);
 			return 0;
 		}
 		constexpr size_t size(json::Type t) const {
-			if (t == json::Type::array && std::holds_alternative<detail::ArrViewObject>(*this))
-				return std::get<detail::ArrViewObject>(*this).size;
-			else if (t == json::Type::object && std::holds_alternative<detail::ObjViewObject>(*this))
-				return std::get<detail::ObjViewObject>(*this).keysAndValues / 2;
-			else if (t == json::Type::string && std::holds_alternative<detail::StrViewObject>(*this))
-				return std::get<detail::StrViewObject>(*this).length;
+			if (fLazy())
+				return fResolve().size(t);
+			if ((t == json::Type::array && isArr()) || (t == json::Type::object && isObj()))
+				return pState->size(pWord);
+			else if (t == json::Type::string && isStr())
+				return pState->length(pWord);
 			return 0;
 		}
 		constexpr bool empty() const {
-			if (std::holds_alternative<detail::ArrViewObject>(*this))
-				return (std::get<detail::ArrViewObject>(*this).size == 0);
-			if (std::holds_alternative<detail::ObjViewObject>(*this))
-				return (std::get<detail::ObjViewObject>(*this).keysAndValues == 0);
-			if (std::holds_alternative<detail::StrViewObject>(*this))
-				return (std::get<detail::StrViewObject>(*this).length == 0);
-			return true;
+			return (size() == 0);
 		}
 		constexpr bool empty(json::Type t) const {
-			if (t == json::Type::array && std::holds_alternative<detail::ArrViewObject>(*this))
-				return (std::get<detail::ArrViewObject>(*this).size == 0);
-			else if (t == json::Type::object && std::holds_alternative<detail::ObjViewObject>(*this))
-				return (std::get<detail::ObjViewObject>(*this).keysAndValues == 0);
-			else if (t == json::Type::string && std::holds_alternative<detail::StrViewObject>(*this))
-				return (std::get<detail::StrViewObject>(*this).length == 0);
-			return true;
+			return (size(t) == 0);
 		}
 
-		json::Viewer operator[](json::StrView k) const {
+		/* keys can be given in utf-8, which are compared directly against the strings of viewers created by json::ViewUtf8 */
+		json::BasicViewer<StateType> operator[](json::StrView k) const {
 			return this->at(k);
 		}
-		json::Viewer at(json::StrView k) const {
-			static json::Viewer nullValue{};
-
-			if (!std::holds_alternative<detail::ObjViewObject>(*this))
-				throw json::TypeException(L"json::Viewer is not a object");
-			detail::ObjViewObject obj = std::get<detail::ObjViewObject>(*this);
-
-			for (size_t i = 0; i < obj.keysAndValues; i += 2) {
-				if (pState->str(obj.offset + i) == k)
-					return json::Viewer{ pState, obj.offset + i + 1 };
-			}
-			return nullValue;
+		json::BasicViewer<StateType> operator[](std::u8string_view k) const {
+			return this->at(k);
+		}
+		json::BasicViewer<StateType> at(json::StrView k) const {
+			return fAt(k);
+		}
+		json::BasicViewer<StateType> at(std::u8string_view k) const {
+			return fAt(k);
 		}
 		constexpr bool contains(json::StrView k) const {
-			if (!std::holds_alternative<detail::ObjViewObject>(*this))
-				return false;
-			detail::ObjViewObject obj = std::get<detail::ObjViewObject>(*this);
-
-			for (size_t i = 0; i < obj.keysAndValues; i += 2) {
-				if (pState->str(obj.offset + i) == k)
-					return true;
-			}
-			return false;
+			return fContains(k, std::nullopt);
+		}
+		constexpr bool contains(std::u8string_view k) const {
+			return fContains(k, std::nullopt);
 		}
 		constexpr bool contains(json::StrView k, json::Type t) const {
-			if (!std::holds_alternative<detail::ObjViewObject>(*this))
-				return false;
-			detail::ObjViewObject obj = std::get<detail::ObjViewObject>(*this);
-
-			for (size_t i = 0; i < obj.keysAndValues; i += 2) {
-				if (pState->str(obj.offset + i) != k)
-					continue;
-				return fConvertible(t, pState->entries[obj.offset + i + 1]);
-			}
-			return false;
+			return fContains(k, t);
+		}
+		constexpr bool contains(std::u8string_view k, json::Type t) const {
+			return fContains(k, t);
 		}
 		constexpr bool typedObject(json::Type t) const {
-			if (!std::holds_alternative<detail::ObjViewObject>(*this))
+			if (!isObj())
 				return false;
-			detail::ObjViewObject obj = std::get<detail::ObjViewObject>(*this);
+			if (fLazy())
+				return fResolve().typedObject(t);
+			size_t offset = fPayload(), count = pState->size(pWord);
 
-			for (size_t i = 0; i < obj.keysAndValues; i += 2) {
-				if (!fConvertible(t, pState->entries[obj.offset + i + 1]))
+			for (size_t i = 0; i < count; ++i) {
+				if (!fConvertible(t, pState->words[offset + 3 + 2 * i]))
 					return false;
 			}
 			return true;
 		}
 
-		json::Viewer operator[](size_t i) const {
+		/* fetch the values of all keys of the set in a single pass over the object, indexed by their ids (keys, which are missing or whose
+		*	values are not convertible to the optional type of their id, are null, and the first of multiple identical keys is used) */
+		template <size_t Count>
+		std::array<json::BasicViewer<StateType>, Count> extract(const json::KeySet<Count>& keys) const {
+			return fExtract(keys, nullptr);
+		}
+		template <size_t Count>
+		std::array<json::BasicViewer<StateType>, Count> extract(const json::KeySet<Count>& keys, const std::array<json::Type, Count>& types) const {
+			return fExtract(keys, types.data());
+		}
+
+		json::BasicViewer<StateType> operator[](size_t i) const {
 			return this->at(i);
 		}
-		json::Viewer at(size_t i) const {
-			if (!std::holds_alternative<detail::ArrViewObject>(*this))
+		json::BasicViewer<StateType> at(size_t i) const {
+			if (!isArr())
 				throw json::TypeException(L"json::Viewer is not a array");
-			detail::ArrViewObject arr = std::get<detail::ArrViewObject>(*this);
+			if (fLazy())
+				return fResolve().at(i);
 
-			if (i >= arr.size)
+			if (i >= pState->size(pWord))
 				throw json::RangeException(L"Array index out of range");
-			return json::Viewer{ pState, arr.offset + i };
+			return json::BasicViewer<StateType>{ pState, pState->words[fPayload() + 1 + i] };
 		}
 		constexpr bool has(size_t i) const {
-			if (!std::holds_alternative<detail::ArrViewObject>(*this))
+			if (!isArr())
 				return false;
-			detail::ArrViewObject arr = std::get<detail::ArrViewObject>(*this);
-
-			return (i < arr.size);
+			if (fLazy())
+				return fResolve().has(i);
+			return (i < pState->size(pWord));
 		}
 		constexpr bool has(size_t i, json::Type t) const {
-			if (!std::holds_alternative<detail::ArrViewObject>(*this))
+			if (!isArr())
 				return false;
-			detail::ArrViewObject arr = std::get<detail::ArrViewObject>(*this);
-
-			return (i < arr.size && fConvertible(t, pState->entries[arr.offset + i]));
+			if (fLazy())
+				return fResolve().has(i, t);
+			return (i < pState->size(pWord) && fConvertible(t, pState->words[fPayload() + 1 + i]));
 		}
 		constexpr bool typedArray(json::Type t) const {
-			if (!std::holds_alternative<detail::ArrViewObject>(*this))
+			if (!isArr())
 				return false;
-			detail::ArrViewObject arr = std::get<detail::ArrViewObject>(*this);
+			if (fLazy())
+				return fResolve().typedArray(t);
+			size_t offset = fPayload(), count = pState->size(pWord);
 
-			for (size_t i = 0; i < arr.size; ++i) {
-				if (!fConvertible(t, pState->entries[arr.offset + i]))
+			for (size_t i = 0; i < count; ++i) {
+				if (!fConvertible(t, pState->words[offset + 1 + i]))
 					return false;
 			}
 			return true;
@@ -410,33 +1135,36 @@ namespace json {
 
 	/* [json::IsJson] json-view of type [array], which can be used to read the corresponding array value
 	*	Note: This is a light-weight object, which can just be copied around, as it keeps a reference to the actual state */
-	class ArrViewer {
-		friend class json::Viewer;
+	template <class StateType>
+	class BasicArrViewer {
+		template <class> friend class json::BasicViewer;
+		template <class> friend class json::BasicArrViewer;
+		friend struct detail::ColumnExtractor;
 	public:
 		struct iterator {
-			friend class json::ArrViewer;
+			friend class json::BasicArrViewer<StateType>;
 		public:
 			using iterator_category = std::input_iterator_tag;
-			using value_type = const json::Viewer;
+			using value_type = const json::BasicViewer<StateType>;
 			using pointer = value_type*;
 			using reference = value_type&;
 
 		private:
-			std::shared_ptr<detail::ViewState> pState;
+			StateType pState{};
 			size_t pIndex = 0;
-			mutable json::Viewer pTemp;
+			mutable json::BasicViewer<StateType> pTemp;
 			mutable bool pSet = false;
 
 		public:
 			constexpr iterator() = default;
 
 		private:
-			iterator(const std::shared_ptr<detail::ViewState>& state, size_t index) : pState{ state }, pIndex{ index } {}
+			iterator(const StateType& state, size_t index) : pState{ state }, pIndex{ index } {}
 
 		private:
 			reference fGet() const {
 				if (!pSet)
-					pTemp = detail::ViewAccess::Make(pState, pIndex);
+					pTemp = json::BasicViewer<StateType>(pState, pState->words[pIndex]);
 				pSet = true;
 				return pTemp;
 			}
@@ -473,73 +1201,81 @@ namespace json {
 		};
 
 	private:
-		std::shared_ptr<detail::ViewState> pState;
-		detail::ArrViewObject pSelf;
+		StateType pState{};
+		size_t pOffset = 0;
+		size_t pSize = 0;
 
 	public:
-		constexpr ArrViewer() = delete;
-		constexpr ArrViewer(json::ArrViewer&&) = default;
-		constexpr ArrViewer(const json::ArrViewer&) = default;
-		constexpr json::ArrViewer& operator=(json::ArrViewer&&) = default;
-		constexpr json::ArrViewer& operator=(const json::ArrViewer&) = default;
+		constexpr BasicArrViewer() = delete;
+		constexpr BasicArrViewer(json::BasicArrViewer<StateType>&&) = default;
+		constexpr BasicArrViewer(const json::BasicArrViewer<StateType>&) = default;
+		constexpr json::BasicArrViewer<StateType>& operator=(json::BasicArrViewer<StateType>&&) = default;
+		constexpr json::BasicArrViewer<StateType>& operator=(const json::BasicArrViewer<StateType>&) = default;
 
 	private:
-		ArrViewer(const std::shared_ptr<detail::ViewState>& state, const detail::ArrViewObject& self) : pState{ state }, pSelf{ self } {}
+		BasicArrViewer(const StateType& state, size_t offset) : pState{ state }, pOffset{ offset }, pSize{ size_t(state->words[offset]) } {}
 
 	public:
-		json::Viewer operator[](size_t index) const {
+		json::BasicViewer<StateType> operator[](size_t index) const {
 			return this->at(index);
 		}
 
 	public:
 		iterator begin() const {
-			return iterator{ pState, pSelf.offset };
+			return iterator{ pState, pOffset + 1 };
 		}
 		iterator end() const {
-			return iterator{ pState, pSelf.offset + pSelf.size };
+			return iterator{ pState, pOffset + 1 + pSize };
 		}
 		constexpr size_t size() const {
-			return pSelf.size;
+			return pSize;
 		}
 		constexpr bool empty() const {
-			return (pSelf.size == 0);
+			return (pSize == 0);
 		}
-		json::Viewer at(size_t index) const {
-			if (index >= pSelf.size)
+		json::BasicViewer<StateType> at(size_t index) const {
+			if (index >= pSize)
 				throw json::RangeException(L"Array index out of range");
-			return detail::ViewAccess::Make(pState, pSelf.offset + index);
+			return json::BasicViewer<StateType>(pState, pState->words[pOffset + 1 + index]);
+		}
+
+		/* construct a non-owning viewer of this array, which can be copied without modifying the shared reference-count */
+		json::ArrViewerRef ref() const {
+			return json::ArrViewerRef{ detail::ViewPointer(pState), pOffset };
 		}
 	};
 
 	/* [json::IsJson] json-view of type [object], which can be used to read the corresponding object value
 	*	Note: This is a light-weight object, which can just be copied around, as it keeps a reference to the actual state */
-	class ObjViewer {
-		friend class json::Viewer;
+	template <class StateType>
+	class BasicObjViewer {
+		template <class> friend class json::BasicViewer;
+		template <class> friend class json::BasicObjViewer;
 	public:
 		struct iterator {
-			friend class json::ObjViewer;
+			friend class json::BasicObjViewer<StateType>;
 		public:
 			using iterator_category = std::input_iterator_tag;
-			using value_type = const std::pair<json::StrView, json::Viewer>;
+			using value_type = const std::pair<json::StrView, json::BasicViewer<StateType>>;
 			using pointer = value_type*;
 			using reference = value_type&;
 
 		private:
-			std::shared_ptr<detail::ViewState> pState;
+			StateType pState{};
 			size_t pIndex = 0;
-			mutable std::pair<json::StrView, json::Viewer> pTemp;
+			mutable std::pair<json::StrView, json::BasicViewer<StateType>> pTemp;
 			mutable bool pSet = false;
 
 		public:
 			constexpr iterator() = default;
 
 		private:
-			iterator(const std::shared_ptr<detail::ViewState>& state, size_t index) : pState{ state }, pIndex{ index } {}
+			iterator(const StateType& state, size_t index) : pState{ state }, pIndex{ index } {}
 
 		private:
 			reference fGet() const {
 				if (!pSet)
-					pTemp = { pState->str(pIndex), detail::ViewAccess::Make(pState, pIndex + 1) };
+					pTemp = { pState->str(pState->words[pIndex]), json::BasicViewer<StateType>(pState, pState->words[pIndex + 1]) };
 				pSet = true;
 				return pTemp;
 			}
@@ -576,70 +1312,303 @@ namespace json {
 		};
 
 	private:
-		std::shared_ptr<detail::ViewState> pState;
-		detail::ObjViewObject pSelf;
+		StateType pState{};
+		size_t pOffset = 0;
+		size_t pSize = 0;
 
 	public:
-		constexpr ObjViewer() = delete;
-		constexpr ObjViewer(json::ObjViewer&&) = default;
-		constexpr ObjViewer(const json::ObjViewer&) = default;
-		constexpr json::ObjViewer& operator=(json::ObjViewer&&) = default;
-		constexpr json::ObjViewer& operator=(const json::ObjViewer&) = default;
+		constexpr BasicObjViewer() = delete;
+		constexpr BasicObjViewer(json::BasicObjViewer<StateType>&&) = default;
+		constexpr BasicObjViewer(const json::BasicObjViewer<StateType>&) = default;
+		constexpr json::BasicObjViewer<StateType>& operator=(json::BasicObjViewer<StateType>&&) = default;
+		constexpr json::BasicObjViewer<StateType>& operator=(const json::BasicObjViewer<StateType>&) = default;
 
 	private:
-		ObjViewer(const std::shared_ptr<detail::ViewState>& state, const detail::ObjViewObject& self) : pState{ state }, pSelf{ self } {}
+		BasicObjViewer(const StateType& state, size_t offset) : pState{ state }, pOffset{ offset }, pSize{ size_t(state->words[offset]) } {}
+
+	private:
+		json::BasicViewer<StateType> fAt(const auto& k) const {
+			static json::BasicViewer<StateType> nullValue{};
+
+			size_t index = pState->find(pOffset, k);
+			if (index == 0)
+				return nullValue;
+			return json::BasicViewer<StateType>(pState, pState->words[index]);
+		}
 
 	public:
-		json::Viewer operator[](json::StrView k) const {
+		json::BasicViewer<StateType> operator[](json::StrView k) const {
+			return this->at(k);
+		}
+		json::BasicViewer<StateType> operator[](std::u8string_view k) const {
 			return this->at(k);
 		}
 
 	public:
 		iterator begin() const {
-			return iterator{ pState, pSelf.offset };
+			return iterator{ pState, pOffset + 2 };
 		}
 		iterator end() const {
-			return iterator{ pState, pSelf.offset + pSelf.keysAndValues };
+			return iterator{ pState, pOffset + 2 + 2 * pSize };
 		}
 		constexpr size_t size() const {
-			return (pSelf.keysAndValues / 2);
+			return pSize;
 		}
 		constexpr bool empty() const {
-			return (pSelf.keysAndValues == 0);
+			return (pSize == 0);
 		}
 		constexpr bool contains(json::StrView k) const {
-			for (size_t i = 0; i < pSelf.keysAndValues; i += 2) {
-				if (pState->str(pSelf.offset + i) == k)
-					return true;
-			}
-			return false;
+			return (pState->find(pOffset, k) != 0);
+		}
+		constexpr bool contains(std::u8string_view k) const {
+			return (pState->find(pOffset, k) != 0);
+		}
+		json::BasicViewer<StateType> at(json::StrView k) const {
+			return fAt(k);
+		}
+		json::BasicViewer<StateType> at(std::u8string_view k) const {
+			return fAt(k);
 		}
-		json::Viewer at(json::StrView k) const {
-			static json::Viewer nullValue{};
 
-			for (size_t i = 0; i < pSelf.keysAndValues; i += 2) {
-				if (pState->str(pSelf.offset + i) == k)
-					return detail::ViewAccess::Make(pState, pSelf.offset + i + 1);
-			}
-			return nullValue;
+		/* fetch the values of all keys of the set in a single pass over the object (equivalent to json::Viewer::extract) */
+		template <size_t Count>
+		std::array<json::BasicViewer<StateType>, Count> extract(const json::KeySet<Count>& keys) const {
+			return json::BasicViewer<StateType>{ pState, detail::ViewState::Make(detail::ViewTag::object, pOffset) }.extract(keys);
+		}
+		template <size_t Count>
+		std::array<json::BasicViewer<StateType>, Count> extract(const json::KeySet<Count>& keys, const std::array<json::Type, Count>& types) const {
+			return json::BasicViewer<StateType>{ pState, detail::ViewState::Make(detail::ViewTag::object, pOffset) }.extract(keys, types);
+		}
+
+		/* construct a non-owning viewer of this object, which can be copied without modifying the shared reference-count */
+		json::ObjViewerRef ref() const {
+			return json::ObjViewerRef{ detail::ViewPointer(pState), pOffset };
 		}
 	};
 
-	inline json::ArrViewer json::Viewer::arr() const {
-		if (!std::holds_alternative<detail::ArrViewObject>(*this))
+	template <class StateType>
+	json::BasicArrViewer<StateType> json::BasicViewer<StateType>::arr() const {
+		if (!isArr())
 			throw json::TypeException(L"json::Viewer is not an array");
-		return json::ArrViewer{ pState, std::get<detail::ArrViewObject>(*this) };
+		if (fLazy())
+			return fResolve().arr();
+		return json::BasicArrViewer<StateType>{ pState, fPayload() };
 	}
-	inline json::ObjViewer json::Viewer::obj() const {
-		if (!std::holds_alternative<detail::ObjViewObject>(*this))
+	template <class StateType>
+	json::BasicObjViewer<StateType> json::BasicViewer<StateType>::obj() const {
+		if (!isObj())
 			throw json::TypeException(L"json::Viewer is not an object");
-		return json::ObjViewer{ pState, std::get<detail::ObjViewObject>(*this) };
+		if (fLazy())
+			return fResolve().obj();
+		return json::BasicObjViewer<StateType>{ pState, fPayload() };
 	}
-	constexpr json::Value json::Viewer::value() const {
-		return json::Value{ *this };
+	template <class StateType>
+	constexpr json::Value json::BasicViewer<StateType>::value() const {
+		return detail::ViewMaterializer::Make(detail::ViewPointer(pState), pWord);
 	}
-	inline json::Viewer json::detail::ViewAccess::Make(const std::shared_ptr<detail::ViewState>& state, size_t index) {
-		return json::Viewer{ state, index };
+	inline json::Viewer json::detail::ViewAccess::Make(const std::shared_ptr<detail::ViewState>& state, detail::ViewWord word) {
+		return json::Viewer{ state, word };
+	}
+	inline const std::shared_ptr<json::detail::ViewState>& json::detail::ViewAccess::State(const json::Viewer& viewer) {
+		return viewer.pState;
+	}
+	inline json::detail::ViewWord json::detail::ViewAccess::Word(const json::Viewer& viewer) {
+		return viewer.pWord;
+	}
+
+	/* construct a json value-viewer from the given utf-8 source and ensure that the entire source is a single valid json-value
+	*	- the source is not copied, but referenced by the strings, and must therefore outlive the viewer and all viewers derived from it
+	*	- strings are only decoded, if they are not contained verbatim in the source (i.e. contain escape-sequences or invalid encodings)
+	*	- strings can be accessed in utf-8 by u8str(), while str() transcodes them once and keeps them alive in the viewer
+	*	- keys can be looked up in utf-8, in which case they are compared directly against the source without transcoding
+	*	- interprets \u escape-sequences as utf-16 encoding
+	*	- expects entire source to be a single json value until the end with optional whitespace padding
+	*	- for objects with multiple identical keys, all occurring keys/values will be accessible, but the first will be returned upon accesses */
+	template <char32_t CodeError = str::err::DefChar>
+	json::Viewer ViewUtf8(std::u8string_view source) {
+		detail::Deserializer<std::u8string_view, CodeError> deserializer{ source };
+		std::shared_ptr<detail::ViewState> state = std::make_shared<detail::ViewState>();
+		state->source = source;
+		state->utf8 = true;
+		detail::ViewWord root = detail::ViewDeserializer<std::u8string_view, CodeError>{ deserializer }.read(*state.get());
+		deserializer.checkDone();
+		state->sync();
+		return detail::ViewAccess::Make(state, root);
+	}
+	template <char32_t CodeError = str::err::DefChar>
+	json::Viewer ViewUtf8(std::string_view source) {
+		return json::ViewUtf8<CodeError>(std::u8string_view{ reinterpret_cast<const char8_t*>(source.data()), source.size() });
+	}
+
+	/* construct a json value-viewer from the messagepack-encoded bytes, which references the utf-8 encoded strings directly in the
+	*	bytes without decoding or copying them (the bytes must outlive the viewer, and only bin/ext-payloads and invalid strings are decoded) */
+	template <char32_t CodeError = str::err::DefChar>
+	json::Viewer ViewUtf8(const json::MsgPackSource& source) {
+		detail::Deserializer<json::MsgPackSource, CodeError> deserializer{ source };
+		std::shared_ptr<detail::ViewState> state = std::make_shared<detail::ViewState>();
+		state->source = std::u8string_view{ reinterpret_cast<const char8_t*>(source.bytes().data()), source.bytes().size() };
+		state->utf8 = true;
+		detail::ViewWord root = detail::ViewDeserializer<json::MsgPackSource, CodeError>{ deserializer }.read(*state.get());
+		deserializer.checkDone();
+		state->sync();
+		return detail::ViewAccess::Make(state, root);
+	}
+
+	/* column of the values of one key, which has been extracted from an array of objects by json::ExtractColumns
+	*	(only the values of the type of the column are filled, and contain one entry per row, whereby null rows are zero/empty)
+	*	- the type must be json::Type::real, inumber, unumber, boolean, or string */
+	struct Column {
+		json::Type type = json::Type::null;
+		std::vector<double> reals;
+		std::vector<json::INum> inums;
+		std::vector<json::UNum> unums;
+		std::vector<json::Bool> booleans;
+		std::vector<json::StrView> strings;
+
+		/* bitmap of the rows, which are not objects, or in which the key is missing or not convertible to the type of the column */
+		std::vector<uint64_t> nulls;
+
+		constexpr bool null(size_t row) const {
+			return ((nulls[row / 64] >> (row % 64)) & 0x01) != 0;
+		}
+	};
+
+	namespace detail {
+		struct ColumnExtractor {
+		private:
+			struct Key {
+				json::StrView wide;
+				std::u8string utf8;
+				size_t hint = 0;
+			};
+
+		private:
+			static bool fMatches(const detail::ViewState& state, detail::ViewWord word, const Key& key) {
+				return (state.utf8 ? state.u8(word) == key.utf8 : state.str(word) == key.wide);
+			}
+			static void fPush(const detail::ViewState* state, detail::ViewWord word, json::Column& column, size_t row) {
+				detail::ViewTag tag = (state == nullptr ? detail::ViewTag::null : detail::ViewState::Tag(word));
+				bool unum = (tag == detail::ViewTag::unum || tag == detail::ViewTag::unumSpill);
+				bool inum = (tag == detail::ViewTag::inum || tag == detail::ViewTag::inumSpill);
+				bool valid = false;
+
+				/* write the value out, if it is convertible to the type of the column, and otherwise write the null-value */
+				switch (column.type) {
+				case json::Type::real:
+					valid = (unum || inum || tag == detail::ViewTag::real);
+					column.reals.push_back(!valid ? 0.0 : (unum ? double(state->unum(word)) : (inum ? double(state->inum(word)) : double(state->real(word)))));
+					break;
+				case json::Type::inumber:
+					valid = (unum || inum);
+					column.inums.push_back(!valid ? 0 : (unum ? json::INum(state->unum(word)) : state->inum(word)));
+					break;
+				case json::Type::unumber:
+					valid = (unum || (inum && state->inum(word) >= 0));
+					column.unums.push_back(!valid ? 0 : (unum ? state->unum(word) : json::UNum(state->inum(word))));
+					break;
+				case json::Type::boolean:
+					valid = (tag == detail::ViewTag::boolean);
+					column.booleans.push_back(valid && detail::ViewState::Payload(word) != 0);
+					break;
+				case json::Type::string:
+					valid = (tag == detail::ViewTag::str || tag == detail::ViewTag::strSpill);
+					column.strings.push_back(valid ? state->str(word) : json::StrView{});
+					break;
+				default:
+					break;
+				}
+				if (!valid)
+					column.nulls[row / 64] |= (uint64_t(0x01) << (row % 64));
+			}
+
+		public:
+			static std::vector<json::Column> Extract(const json::ArrViewerRef& arr, std::span<const std::pair<json::StrView, json::Type>> columns) {
+				std::vector<json::Column> out(columns.size());
+				std::vector<Key> keys(columns.size());
+				for (size_t i = 0; i < columns.size(); ++i) {
+					/* check if the type of the column has a corresponding vector of values */
+					json::Type type = columns[i].second;
+					if (type != json::Type::real && type != json::Type::inumber && type != json::Type::unumber && type != json::Type::boolean && type != json::Type::string)
+						throw json::TypeException(L"json::Column is not a number, boolean, or string");
+					out[i].type = columns[i].second;
+					out[i].nulls.resize((arr.pSize + 63) / 64, 0);
+					keys[i].wide = columns[i].first;
+					str::TranscodeAllTo<str::err::DefChar>(keys[i].utf8, columns[i].first);
+				}
+
+				for (size_t row = 0; row < arr.pSize; ++row) {
+					const detail::ViewState* state = arr.pState;
+					detail::ViewWord word = state->words[arr.pOffset + 1 + row];
+
+					/* materialize lazy objects and mark all columns of non-object rows as null */
+					if (detail::ViewState::Tag(word) == detail::ViewTag::lazyObject)
+						std::tie(state, word) = state->lazy->resolve(detail::ViewState::Payload(word));
+					if (detail::ViewState::Tag(word) != detail::ViewTag::object) {
+						for (json::Column& column : out)
+							fPush(nullptr, 0, column, row);
+						continue;
+					}
+					size_t obj = detail::ViewState::Payload(word), count = state->size(word);
+
+					/* check if the key is at the same position as in the previous row, and otherwise look it up */
+					for (size_t i = 0; i < out.size(); ++i) {
+						size_t index = 0;
+						if (keys[i].hint < count && fMatches(*state, state->words[obj + 2 + 2 * keys[i].hint], keys[i]))
+							index = obj + 3 + 2 * keys[i].hint;
+						else if ((index = state->find(obj, keys[i].wide)) != 0)
+							keys[i].hint = (index - obj - 3) / 2;
+
+						if (index == 0)
+							fPush(nullptr, 0, out[i], row);
+						else
+							fPush(state, state->words[index], out[i], row);
+					}
+				}
+				return out;
+			}
+		};
+	}
+
+	/* extract the values of the keys from all objects of the array in a single pass into contiguous columns of the corresponding types
+	*	(rows, which are not objects, or which do not contain the key with a value convertible to the type, are marked as null)
+	*	- the positions of the keys are remembered, and are therefore found immediately, if all objects share the same order of keys
+	*	- for objects with multiple identical keys, any of the occurrences might be used
+	*	- strings reference the state of the viewer, and remain valid as long as any viewer of the state exists
+	*	- throws json::TypeException for columns of types other than numbers, booleans, or strings */
+	template <class StateType>
+	std::vector<json::Column> ExtractColumns(const json::BasicArrViewer<StateType>& arr, std::span<const std::pair<json::StrView, json::Type>> columns) {
+		return detail::ColumnExtractor::Extract(arr.ref(), columns);
+	}
+	template <class StateType>
+	std::vector<json::Column> ExtractColumns(const json::BasicArrViewer<StateType>& arr, std::initializer_list<std::pair<json::StrView, json::Type>> columns) {
+		return detail::ColumnExtractor::Extract(arr.ref(), std::span<const std::pair<json::StrView, json::Type>>{ columns.begin(), columns.size() });
+	}
+
+	/* construct a lazy json value-viewer from the given utf-8 source, which only scans the structure of the source upfront, and decodes
+	*	the values of an array or object once it is accessed for the first time (the decoded containers are kept alive by the viewer)
+	*	- the source is not copied, but referenced by the strings, and must therefore outlive the viewer and all viewers derived from it
+	*	- only the brackets and strings are validated upfront, all other errors are reported once the surrounding container is accessed
+	*	- positions in errors are reported as offsets into the source
+	*	- strings are accessible through u8str() and str() (see json::ViewUtf8)
+	*	- for objects with multiple identical keys, all occurring keys/values will be accessible, but the first will be returned upon accesses */
+	template <char32_t CodeError = str::err::DefChar>
+	json::Viewer ViewLazy(std::u8string_view source) {
+		std::shared_ptr<detail::LazyView> lazy = std::make_shared<detail::LazyView>(source);
+		lazy->materialize = &detail::LazyMaterialize<CodeError>;
+
+		/* check if the source is a single container, as primitive values are decoded immediately */
+		size_t begin = source.find_first_not_of(u8" \t\r\n");
+		if (lazy->spans.empty() || lazy->spans[0].begin != begin || lazy->spans[0].nested + 1 != lazy->spans.size())
+			return json::ViewUtf8<CodeError>(source);
+		if (source.find_first_not_of(u8" \t\r\n", lazy->spans[0].end + 1) != std::u8string_view::npos)
+			return json::ViewUtf8<CodeError>(source);
+
+		detail::ViewTag tag = (source[begin] == u8'{' ? detail::ViewTag::lazyObject : detail::ViewTag::lazyArray);
+		return detail::ViewAccess::Make(std::shared_ptr<detail::ViewState>{ lazy, &lazy->base }, detail::ViewState::Make(tag, 0));
+	}
+	template <char32_t CodeError = str::err::DefChar>
+	json::Viewer ViewLazy(std::string_view source) {
+		return json::ViewLazy<CodeError>(std::u8string_view{ reinterpret_cast<const char8_t*>(source.data()), source.size() });
 	}
 
 	/* construct a json value-viewer from the given stream and ensure that the entire stream is a single valid json-value
@@ -647,11 +1616,27 @@ namespace json {
 	*	- expects entire stream to be a single json value until the end with optional whitespace padding
 	*	- for objects with multiple identical keys, all occurring keys/values will be accessible, but the first will be returned upon accesses */
 	template <char32_t CodeError = str::err::DefChar>
-	constexpr json::Viewer View(str::IsStream auto&& stream) {
+	constexpr json::Viewer View(json::IsInput auto&& stream) {
 		using StreamType = decltype(stream);
 
+		detail::Deserializer<std::remove_reference_t<StreamType>, CodeError> deserializer{ std::forward<StreamType>(stream) };
+		std::shared_ptr<detail::ViewState> state = std::make_shared<detail::ViewState>();
+		detail::ViewWord root = detail::ViewDeserializer<std::remove_reference_t<StreamType>, CodeError>{ deserializer }.read(*state.get());
+		deserializer.checkDone();
+		state->sync();
+		return detail::ViewAccess::Make(state, root);
+	}
+
+	/* construct an immutable json value-viewer by writing the value into a compact tape, which is detached from the value
+	*	- objects with many keys are indexed by hash-tables, and identical strings are only stored once
+	*	- reading never modifies the state, which can therefore be shared across threads without locking
+	*	  (use ref() within hot threads, to not contend on the shared reference-count when copying viewers) */
+	inline json::Viewer Freeze(const json::Value& value) {
 		std::shared_ptr<detail::ViewState> state = std::make_shared<detail::ViewState>();
-		detail::ViewDeserializer<std::remove_reference_t<StreamType>, CodeError> _deserializer{ std::forward<StreamType>(stream), *state.get() };
-		return detail::ViewAccess::Make(state, 0);
+		detail::ViewWord root = detail::ValueFreezer{}.read(*state.get(), value);
+		state->tape.shrink_to_fit();
+		state->strings.shrink_to_fit();
+		state->sync();
+		return detail::ViewAccess::Make(state, root);
 	}
 }
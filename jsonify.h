@@ -7,4 +7,9 @@
 #include "json-viewer.h"
 #include "json-serialize.h"
 #include "json-deserialize.h"
+#include "json-projection.h"
+#include "json-schema.h"
+#include "json-cbor.h"
+#include "json-msgpack.h"
+#include "json-snapshot.h"
 #include "json-value.h"